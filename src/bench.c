@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "life.h"
+#include "util.h"
+
+static const uint32_t gBenchSides[] = { 256, 1024, 2048 };
+static const unsigned gBenchDensities[] = { 10, 30, 50 }; /* percent of live cells */
+static const uint64_t gBenchGenerations[] = { 100, 1000 };
+
+const uint64_t DEFAULT_BENCH_SEED = 1;
+
+struct benchResult_t {
+    const char * kernel;
+    uint32_t     side;
+    unsigned     density;
+    uint64_t     generations;
+    double       medianNs;  /* per generation */
+    double       p95Ns;
+    double       cellUpdatesPerSecond;
+};
+
+static int CompareTimes( const void * a, const void * b ) {
+    uint64_t left = *(const uint64_t *) a, right = *(const uint64_t *) b;
+
+    return ( left > right ) - ( left < right );
+}
+
+static void RunCase( struct gameOfLife_t * gameOfLife, const struct options_t * options, unsigned density,
+                     uint64_t generations, uint64_t * times ) {
+    uint64_t seed = options->seeded ? options->seed : DEFAULT_BENCH_SEED;
+
+    /* every trial starts from the same soup, the first ones only warm up */
+    for ( unsigned trial = 0; trial < options->warmupTrials + options->trials; trial++ ) {
+        uint64_t startTime;
+
+        RandomizeSimulation( gameOfLife, seed, density );
+
+        startTime = NanoTime();
+        AdvanceSimulation( gameOfLife, generations );
+
+        if ( trial >= options->warmupTrials ) {
+            times[trial - options->warmupTrials] = NanoTime() - startTime;
+        }
+    }
+
+    qsort( times, options->trials, sizeof ( uint64_t ), CompareTimes );
+}
+
+static void PrintResult( const struct benchResult_t * result, enum benchFormat_t format, bool first ) {
+    if ( format == BENCH_JSON ) {
+        printf( "%s\n  { \"kernel\": \"%s\", \"width\": %u, \"height\": %u, \"density\": %u, \"generations\": %llu, "
+                "\"median_ns_per_generation\": %.1f, \"p95_ns_per_generation\": %.1f, \"cell_updates_per_second\": %.4e }",
+                first ? "" : ",", result->kernel, result->side, result->side, result->density,
+                (unsigned long long) result->generations, result->medianNs, result->p95Ns,
+                result->cellUpdatesPerSecond );
+        return;
+    }
+
+    printf( "%s,%u,%u,%u,%llu,%.1f,%.1f,%.4e\n",
+            result->kernel, result->side, result->side, result->density, (unsigned long long) result->generations,
+            result->medianNs, result->p95Ns, result->cellUpdatesPerSecond );
+}
+
+void RunBenchmark( const struct options_t * options ) {
+    uint64_t * times = malloc( options->trials * sizeof ( uint64_t ) );
+    bool       first = true;
+
+    if ( times == NULL ) {
+        Abort( "Cannot allocate the benchmark trials" );
+    }
+
+    if ( options->benchFormat == BENCH_JSON ) {
+        printf( "[" );
+    } else {
+        puts( "kernel,width,height,density,generations,median_ns_per_generation,p95_ns_per_generation,"
+              "cell_updates_per_second" );
+    }
+
+    for ( unsigned k = 0; GetKernel( k ) != NULL; k++ ) {
+        if ( !GetKernel( k )->isSupported() ) {
+            continue;
+        }
+
+        for ( unsigned s = 0; s < ARRAY_SIZE( gBenchSides, uint32_t ); s++ ) {
+            struct options_t caseOptions = *options;
+            struct gameOfLife_t gameOfLife = { 0 };
+
+            caseOptions.kernel = GetKernel( k );
+            caseOptions.width = caseOptions.height = gBenchSides[s];
+            caseOptions.patternPath = NULL;
+            InitializeSimulation( &gameOfLife, &caseOptions );
+
+            for ( unsigned d = 0; d < ARRAY_SIZE( gBenchDensities, unsigned ); d++ ) {
+                for ( unsigned g = 0; g < ARRAY_SIZE( gBenchGenerations, uint64_t ); g++ ) {
+                    struct benchResult_t result = {
+                        .kernel = caseOptions.kernel->name,
+                        .side = gBenchSides[s],
+                        .density = gBenchDensities[d],
+                        .generations = gBenchGenerations[g]
+                    };
+
+                    RunCase( &gameOfLife, &caseOptions, result.density, result.generations, times );
+
+                    /* nearest rank percentiles */
+                    result.medianNs = (double) times[( options->trials - 1 ) / 2] / result.generations;
+                    result.p95Ns = (double) times[( options->trials * 95 + 99 ) / 100 - 1] / result.generations;
+                    result.cellUpdatesPerSecond = (double) result.side * result.side / result.medianNs * 1e9;
+
+                    PrintResult( &result, options->benchFormat, first );
+                    fflush( stdout );
+                    first = false;
+                }
+            }
+
+            DestroySimulation( &gameOfLife );
+        }
+    }
+
+    if ( options->benchFormat == BENCH_JSON ) {
+        printf( "\n]\n" );
+    }
+
+    free( times );
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "options.h"
+
+/* Times every kernel this processor supports over a matrix of board sides,
+   soup densities and run lengths, and prints the median and 95th
+   percentile of the trials to stdout as CSV or JSON. The rule, boundary,
+   seed and thread count come from the options. */
+void RunBenchmark( const struct options_t * );
+
+#endif
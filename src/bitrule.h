@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BITRULE_H
+#define BITRULE_H
+
+/* The rule applied to 64 cells at once, shared by the engines that keep a
+   cell per bit: the eight neighbours are summed with a small carry-save
+   adder network into the bit planes of the count, which are then matched
+   against the rule. */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rule.h"
+
+static inline void HalfAdd( uint64_t a, uint64_t b, uint64_t * sum, uint64_t * carry ) {
+    *sum   = a ^ b;
+    *carry = a & b;
+}
+
+static inline void FullAdd( uint64_t a, uint64_t b, uint64_t c, uint64_t * sum, uint64_t * carry ) {
+    uint64_t partial = a ^ b;
+
+    *sum   = partial ^ c;
+    *carry = ( a & b ) | ( partial & c );
+}
+
+/* The rule as masks for the bit planes of the neighbour count: for every
+   count leading to a live cell, the plane values it matches and which of
+   the dead and live cells it applies to. */
+struct bitRule_t {
+    unsigned counts;
+    uint64_t ones[9], twos[9], fours[9], eights[9];
+    uint64_t born[9], kept[9];
+};
+
+static inline void CompileBitRule( const struct rule_t * rule, struct bitRule_t * bitRule ) {
+    bitRule->counts = 0;
+    for ( unsigned count = 0; count < 9; count++ ) {
+        unsigned i = bitRule->counts;
+
+        if ( !rule->next[0][count] && !rule->next[1][count] ) {
+            continue;
+        }
+
+        bitRule->ones[i] = -(uint64_t) ( count & 1 );
+        bitRule->twos[i] = -(uint64_t) ( ( count >> 1 ) & 1 );
+        bitRule->fours[i] = -(uint64_t) ( ( count >> 2 ) & 1 );
+        bitRule->eights[i] = -(uint64_t) ( count >> 3 );
+        bitRule->born[i] = -(uint64_t) rule->next[0][count];
+        bitRule->kept[i] = -(uint64_t) rule->next[1][count];
+        bitRule->counts++;
+    }
+}
+
+/* The next state of the cells from their neighbour count planes. Conway is
+   a constant when inlined, so its shorter expression needs no table and
+   the rule may be NULL. */
+static inline __attribute__(( always_inline )) uint64_t BitRuleNext( const struct bitRule_t * rule, bool conway,
+                                 uint64_t cells, uint64_t ones, uint64_t twos, uint64_t fours, uint64_t eights ) {
+    uint64_t next = 0;
+
+    if ( conway ) {
+        /* alive next generation with exactly 3 neighbours, or 2 if already alive */
+        return twos & ~fours & ~eights & ( ones | cells );
+    }
+
+    for ( unsigned i = 0; i < rule->counts; i++ ) {
+        uint64_t match = ~( ( ones ^ rule->ones[i] ) | ( twos ^ rule->twos[i] ) |
+                            ( fours ^ rule->fours[i] ) | ( eights ^ rule->eights[i] ) );
+
+        next |= match & ( ( cells & rule->kept[i] ) | ( ~cells & rule->born[i] ) );
+    }
+
+    return next;
+}
+
+#endif
@@ -0,0 +1,351 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Board storage, the halo, and the bit-parallel generation step: 64 cells
+   are updated at once by summing the eight neighbour words with a small
+   carry-save adder network and matching the sum against the rule. The
+   ghost cells around the board make the inner loop the same for every
+   word. */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bitrule.h"
+#include "board.h"
+#include "random.h"
+#include "stats.h"
+#include "util.h"
+
+#define WORDS_PER_LINE ( BOARD_ALIGNMENT / sizeof ( uint64_t ) )
+
+/* the next generation of a word of cells, given the words before it */
+static inline __attribute__(( always_inline )) uint64_t NextWord( const struct bitRule_t * rule, bool conway,
+                                 const uint64_t * north, const uint64_t * middle, const uint64_t * south, uint32_t word,
+                                 uint64_t northWest, uint64_t middleWest, uint64_t southWest ) {
+    uint64_t sumNorth, carryNorth, sumMiddle, carryMiddle, sumSouth, carrySouth;
+    uint64_t ones, carryOnes, twosPartial, carryTwos, twos, carryFours;
+    uint64_t n = north[word], m = middle[word], s = south[word];
+
+    /* count the eight neighbours as the bit planes ones/twos/fours/eights */
+    FullAdd( ( n << 1 ) | ( northWest >> 63 ), n, ( n >> 1 ) | ( north[word + 1] << 63 ), &sumNorth, &carryNorth );
+    FullAdd( ( m << 1 ) | ( middleWest >> 63 ), ( m >> 1 ) | ( middle[word + 1] << 63 ),
+             ( s << 1 ) | ( southWest >> 63 ), &sumMiddle, &carryMiddle );
+    HalfAdd( s, ( s >> 1 ) | ( south[word + 1] << 63 ), &sumSouth, &carrySouth );
+
+    FullAdd( sumNorth, sumMiddle, sumSouth, &ones, &carryOnes );
+    FullAdd( carryNorth, carryMiddle, carrySouth, &twosPartial, &carryTwos );
+    HalfAdd( twosPartial, carryOnes, &twos, &carryFours );
+
+    uint64_t fours  = carryTwos ^ carryFours;
+    uint64_t eights = carryTwos & carryFours;
+
+    return BitRuleNext( rule, conway, m, ones, twos, fours, eights );
+}
+
+/* a cell or ghost cell by its position in the row, the ghosts being 0 and width + 1 */
+static inline int GetPosition( const struct board_t * board, const uint64_t * row, uint32_t position ) {
+    if ( board->layout == LAYOUT_BYTES ) {
+        return ( (const uint8_t *) row )[position];
+    }
+
+    return ( row[position >> 6] >> ( position & 63 ) ) & 1;
+}
+
+static inline void PutPosition( const struct board_t * board, uint64_t * row, uint32_t position, int value ) {
+    uint64_t mask = UINT64_C( 1 ) << ( position & 63 );
+
+    if ( board->layout == LAYOUT_BYTES ) {
+        ( (uint8_t *) row )[position] = value;
+    } else {
+        row[position >> 6] = ( row[position >> 6] & ~mask ) | ( value ? mask : 0 );
+    }
+}
+
+void BoardAllocate( struct board_t * board, uint32_t width, uint32_t height, enum cellLayout_t layout ) {
+    size_t   bytes;
+    uint32_t usedWords;
+
+    if ( width == 0 || height == 0 || width > MAX_BOARD_SIDE || height > MAX_BOARD_SIDE ) {
+        Abort( "Invalid board size" );
+    }
+
+    board->width = width;
+    board->height = height;
+    board->layout = layout;
+
+    if ( layout == LAYOUT_BYTES ) {
+        board->wordsPerRow = ( width + 2 + 7 ) / 8;
+        usedWords = board->wordsPerRow;
+    } else {
+        /* the spare word lets the step read one word past the end of every row */
+        board->wordsPerRow = ( width + 2 + 63 ) / 64;
+        usedWords = board->wordsPerRow + 1;
+    }
+
+    board->stride = ( usedWords + WORDS_PER_LINE - 1 ) / WORDS_PER_LINE * WORDS_PER_LINE;
+
+    bytes = BoardBytes( board );
+    board->storage = aligned_alloc( BOARD_ALIGNMENT, bytes );
+    if ( board->storage == NULL ) {
+        Abort( "Cannot allocate the board" );
+    }
+
+    memset( board->storage, 0, bytes );
+    board->words = board->storage + board->stride;
+}
+
+void BoardFree( struct board_t * board ) {
+    free( board->storage );
+    board->storage = NULL;
+    board->words = NULL;
+}
+
+size_t BoardBytes( const struct board_t * board ) {
+    return ( (size_t) board->height + 2 ) * board->stride * sizeof ( uint64_t );
+}
+
+void BoardClear( struct board_t * board ) {
+    memset( board->storage, 0, BoardBytes( board ) );
+}
+
+void BoardSetRun( struct board_t * board, uint32_t row, uint32_t col, uint32_t count ) {
+    uint64_t * words = BoardRow( board, row );
+    uint32_t   position = col + 1, end = col + 1 + count;
+
+    if ( board->layout == LAYOUT_BYTES ) {
+        memset( BoardRowBytes( board, row ) + position, 1, count );
+        return;
+    }
+
+    while ( position < end ) {
+        uint32_t bit = position & 63;
+        uint32_t bits = ( end - position < 64 - bit ) ? end - position : 64 - bit;
+
+        words[position >> 6] |= ( ( bits == 64 ) ? ~UINT64_C( 0 ) : ( UINT64_C( 1 ) << bits ) - 1 ) << bit;
+        position += bits;
+    }
+}
+
+/* eight cells, one per bit, as eight byte cells */
+static inline uint64_t SpreadBits( uint64_t bits ) {
+    bits = ( bits | bits << 28 ) & UINT64_C( 0x0000000f0000000f );
+    bits = ( bits | bits << 14 ) & UINT64_C( 0x0003000300030003 );
+    return ( bits | bits << 7 ) & UINT64_C( 0x0101010101010101 );
+}
+
+/* cells [ colBegin, colEnd ) of a row, within the same group of 64 */
+static void WriteCells( struct board_t * board, uint32_t row, uint32_t colBegin, uint32_t colEnd, uint64_t cells ) {
+    if ( board->layout == LAYOUT_BYTES ) {
+        uint8_t * bytes = BoardRowBytes( board, row ) + 1;
+        uint32_t col = colBegin;
+
+        for ( ; col < colEnd && ( col & 7 ) != 0; col++ ) {
+            bytes[col] = ( cells >> ( col & 63 ) ) & 1;
+        }
+        for ( ; col + 8 <= colEnd; col += 8 ) {
+            uint64_t spread = SpreadBits( ( cells >> ( col & 63 ) ) & 0xff );
+
+            memcpy( bytes + col, &spread, sizeof ( spread ) );
+        }
+        for ( ; col < colEnd; col++ ) {
+            bytes[col] = ( cells >> ( col & 63 ) ) & 1;
+        }
+        return;
+    }
+
+    /* the group is the positions 64 * group + 1 on, across two words */
+    uint64_t * words = BoardRow( board, row ) + ( colBegin >> 6 );
+    uint32_t   count = colEnd - colBegin;
+    uint64_t   mask = ( ( count == 64 ) ? ~UINT64_C( 0 ) : ( UINT64_C( 1 ) << count ) - 1 ) << ( colBegin & 63 );
+
+    cells &= mask;
+    words[0] = ( words[0] & ~( mask << 1 ) ) | cells << 1;
+    words[1] = ( words[1] & ~( mask >> 63 ) ) | cells >> 63;
+}
+
+void BoardFillRandom( struct board_t * board, uint64_t seed, unsigned density,
+                      uint32_t rowBegin, uint32_t rowEnd, uint32_t colBegin, uint32_t colEnd ) {
+    uint32_t threshold = RandomThreshold( density );
+
+    for ( uint32_t row = rowBegin; row < rowEnd; row++ ) {
+        for ( uint32_t col = colBegin; col < colEnd; ) {
+            uint32_t group = col >> 6;
+            uint32_t end = ( (uint64_t) group * 64 + 64 < colEnd ) ? group * 64 + 64 : colEnd;
+
+            WriteCells( board, row, col, end, RandomCells( seed, row, group, threshold ) );
+            col = end;
+        }
+    }
+}
+
+uint64_t BoardPopulation( const struct board_t * board ) {
+    uint64_t population = 0;
+
+    if ( board->layout == LAYOUT_BYTES ) {
+        for ( uint32_t row = 0; row < board->height; row++ ) {
+            const uint8_t * cells = BoardRowBytes( board, row ) + 1;
+
+            for ( uint32_t col = 0; col < board->width; col++ ) {
+                population += cells[col];
+            }
+        }
+
+        return population;
+    }
+
+    uint32_t lastCellWord = board->width >> 6;
+    uint64_t lastCellMask = ~UINT64_C( 0 ) >> ( 63 - ( board->width & 63 ) );
+
+    for ( uint32_t row = 0; row < board->height; row++ ) {
+        const uint64_t * words = BoardRow( board, row );
+
+        /* the ghost cells may still hold the halo of the last step */
+        population -= words[0] & 1;
+        for ( uint32_t word = 0; word < lastCellWord; word++ ) {
+            population += __builtin_popcountll( words[word] );
+        }
+        population += __builtin_popcountll( words[lastCellWord] & lastCellMask );
+    }
+
+    return population;
+}
+
+void BoardFillRowHalo( struct board_t * board, uint32_t rowBegin, uint32_t rowEnd, enum boundary_t boundary ) {
+    uint32_t width = board->width;
+
+    for ( uint32_t row = rowBegin; row < rowEnd; row++ ) {
+        uint64_t * words = BoardRow( board, row );
+
+        switch ( boundary ) {
+        case BOUNDARY_DEAD:
+            PutPosition( board, words, 0, 0 );
+            PutPosition( board, words, width + 1, 0 );
+            break;
+
+        case BOUNDARY_TORUS:
+            PutPosition( board, words, 0, GetPosition( board, words, width ) );
+            PutPosition( board, words, width + 1, GetPosition( board, words, 1 ) );
+            break;
+
+        case BOUNDARY_MIRROR:
+            PutPosition( board, words, 0, GetPosition( board, words, 1 ) );
+            PutPosition( board, words, width + 1, GetPosition( board, words, width ) );
+            break;
+        }
+    }
+}
+
+void BoardFillHalo( struct board_t * board, enum boundary_t boundary ) {
+    uint32_t height = board->height;
+    size_t   rowBytes = board->wordsPerRow * sizeof ( uint64_t );
+
+    /* ghost columns first, so the corners come along with the ghost rows */
+    BoardFillRowHalo( board, 0, height, boundary );
+
+    switch ( boundary ) {
+    case BOUNDARY_DEAD:
+        memset( BoardRow( board, -1 ), 0, rowBytes );
+        memset( BoardRow( board, height ), 0, rowBytes );
+        break;
+
+    case BOUNDARY_TORUS:
+        memcpy( BoardRow( board, -1 ), BoardRow( board, height - 1 ), rowBytes );
+        memcpy( BoardRow( board, height ), BoardRow( board, 0 ), rowBytes );
+        break;
+
+    case BOUNDARY_MIRROR:
+        memcpy( BoardRow( board, -1 ), BoardRow( board, 0 ), rowBytes );
+        memcpy( BoardRow( board, height ), BoardRow( board, height - 1 ), rowBytes );
+        break;
+    }
+}
+
+static inline __attribute__(( always_inline )) int StepTile( const struct bitRule_t * rule, bool conway,
+                            const struct board_t * src, struct board_t * dst, uint32_t rowBegin, uint32_t rowEnd,
+                            uint32_t wordBegin, uint32_t wordEnd, struct tileStats_t * stats ) {
+    uint32_t lastCellWord = src->width >> 6; /* the last cell is bit width */
+    uint64_t lastCellMask = ~UINT64_C( 0 ) >> ( 63 - ( src->width & 63 ) );
+    uint32_t innerEnd = ( wordEnd < lastCellWord ) ? wordEnd : lastCellWord;
+    uint64_t changed = 0;
+
+    for ( uint32_t row = rowBegin; row < rowEnd; row++ ) {
+        const uint64_t * north = BoardRow( src, (int64_t) row - 1 );
+        const uint64_t * south = BoardRow( src, (int64_t) row + 1 );
+        const uint64_t * middle = BoardRow( src, row );
+        uint64_t * next = BoardRow( dst, row );
+        uint32_t word = wordBegin;
+
+        /* word 0 has no word before it and holds the west ghost cell */
+        if ( word == 0 ) {
+            uint64_t cells = ~UINT64_C( 1 ) & ( ( lastCellWord == 0 ) ? lastCellMask : ~UINT64_C( 0 ) );
+
+            next[0] = cells & NextWord( rule, conway, north, middle, south, 0, 0, 0, 0 );
+            changed |= ( next[0] ^ middle[0] ) & cells;
+            if ( stats != NULL ) {
+                StatsAddChange( stats, middle[0] & cells, next[0] );
+            }
+            word++;
+        }
+
+        for ( ; word < innerEnd; word++ ) {
+            next[word] = NextWord( rule, conway, north, middle, south, word,
+                                   north[word - 1], middle[word - 1], south[word - 1] );
+            changed |= next[word] ^ middle[word];
+            if ( stats != NULL ) {
+                StatsAddChange( stats, middle[word], next[word] );
+            }
+        }
+
+        /* the east ghost cell and the padding */
+        for ( ; word < wordEnd; word++ ) {
+            uint64_t cells = ( word == lastCellWord ) ? lastCellMask : 0;
+
+            next[word] = cells & NextWord( rule, conway, north, middle, south, word,
+                                           north[word - 1], middle[word - 1], south[word - 1] );
+            changed |= ( next[word] ^ middle[word] ) & cells;
+            if ( stats != NULL ) {
+                StatsAddChange( stats, middle[word] & cells, next[word] );
+            }
+        }
+
+        if ( stats != NULL ) {
+            StatsAddBounds( stats, dst, row, next, wordBegin, wordEnd );
+        }
+    }
+
+    return changed != 0;
+}
+
+void BoardStep( const struct rule_t * rule, const struct board_t * src, struct board_t * dst ) {
+    BoardStepTile( rule, src, dst, 0, src->height, 0, src->wordsPerRow, NULL );
+}
+
+int BoardStepTile( const struct rule_t * rule, const struct board_t * src, struct board_t * dst,
+                   uint32_t rowBegin, uint32_t rowEnd, uint32_t wordBegin, uint32_t wordEnd, struct tileStats_t * stats ) {
+    struct bitRule_t bitRule;
+
+    /* a body of its own without statistics keeps their test out of the loop */
+    if ( RuleIsConway( rule ) ) {
+        return ( stats != NULL ) ? StepTile( NULL, true, src, dst, rowBegin, rowEnd, wordBegin, wordEnd, stats )
+                                 : StepTile( NULL, true, src, dst, rowBegin, rowEnd, wordBegin, wordEnd, NULL );
+    }
+
+    CompileBitRule( rule, &bitRule );
+    return ( stats != NULL ) ? StepTile( &bitRule, false, src, dst, rowBegin, rowEnd, wordBegin, wordEnd, stats )
+                             : StepTile( &bitRule, false, src, dst, rowBegin, rowEnd, wordBegin, wordEnd, NULL );
+}
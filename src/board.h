@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rule.h"
+
+#define DEFAULT_BOARD_SIDE 200
+#define MAX_BOARD_SIDE     ( 1u << 20 )
+#define BOARD_ALIGNMENT    64 /* bytes, every row starts on its own cache line */
+
+/* how the cells of a row are stored, chosen by the stepping kernel */
+enum cellLayout_t {
+    LAYOUT_BITS,  /* one bit per cell, 64 cells per word */
+    LAYOUT_BYTES  /* one byte per cell holding 0 or 1 */
+};
+
+/* what lies beyond the edges of the board */
+enum boundary_t {
+    BOUNDARY_DEAD,   /* a fixed frame of dead cells */
+    BOUNDARY_TORUS,  /* opposite edges are neighbours */
+    BOUNDARY_MIRROR  /* the edge cells are reflected outwards */
+};
+
+/* The board is either bit-packed, one bit per cell, or one byte per cell,
+   every row padded to whole 64-bit words. Each row is framed by a ghost cell
+   on both sides, so cell ( row, col ) is bit or byte col + 1 of the row, and
+   the storage has a ghost row above and below the board. BoardFillHalo()
+   copies the boundary into the ghosts before a step; the kernels only write
+   cells, so the ghosts may still hold an old halo and whoever reads whole
+   words masks them out. Rows are stride words apart, and a bit-packed row
+   has a spare word so the kernel can read one word past the last cell. */
+struct board_t {
+    uint32_t   width;
+    uint32_t   height;
+    enum cellLayout_t layout;
+    uint32_t   wordsPerRow; /* words holding cells and ghost cells */
+    uint32_t   stride;      /* words from one row to the next */
+    uint64_t * storage;     /* aligned allocation, including the ghost rows */
+    uint64_t * words;       /* first word of row 0 */
+};
+
+/* inclusive, in board coordinates */
+struct boundingBox_t {
+    int64_t left;
+    int64_t top;
+    int64_t right;
+    int64_t bottom;
+};
+
+struct tileStats_t;
+
+static inline uint64_t * BoardRow( const struct board_t * board, int64_t row ) {
+    return board->words + row * (int64_t) board->stride;
+}
+
+static inline uint8_t * BoardRowBytes( const struct board_t * board, int64_t row ) {
+    return (uint8_t *) BoardRow( board, row );
+}
+
+static inline int BoardGetCell( const struct board_t * board, uint32_t row, uint32_t col ) {
+    col++;
+    if ( board->layout == LAYOUT_BYTES ) {
+        return BoardRowBytes( board, row )[col];
+    }
+
+    return ( BoardRow( board, row )[col >> 6] >> ( col & 63 ) ) & 1;
+}
+
+static inline void BoardSetCell( struct board_t * board, uint32_t row, uint32_t col, int alive ) {
+    uint64_t mask = UINT64_C( 1 ) << ( ++col & 63 );
+
+    if ( board->layout == LAYOUT_BYTES ) {
+        BoardRowBytes( board, row )[col] = alive ? 1 : 0;
+    } else if ( alive ) {
+        BoardRow( board, row )[col >> 6] |= mask;
+    } else {
+        BoardRow( board, row )[col >> 6] &= ~mask;
+    }
+}
+
+/* the cells of a row word, leaving out the ghost cells and the padding */
+static inline uint64_t BoardCellMask( const struct board_t * board, uint32_t word ) {
+    unsigned shift = ( board->layout == LAYOUT_BYTES ) ? 3 : 0;
+    uint64_t firstPosition = (uint64_t) word << ( 6 - shift );
+    uint64_t positions, mask;
+
+    if ( firstPosition > board->width ) {
+        return 0;
+    }
+
+    positions = board->width + 1 - firstPosition;
+    mask = ( ( positions << shift ) >= 64 ) ? ~UINT64_C( 0 ) : ( UINT64_C( 1 ) << ( positions << shift ) ) - 1;
+    return ( word == 0 ) ? mask & ~( ( UINT64_C( 1 ) << ( 1u << shift ) ) - 1 ) : mask;
+}
+
+/* a word of a row without its ghost cells, only the words holding one need masking */
+static inline uint64_t BoardCells( const struct board_t * board, const uint64_t * words, uint32_t word ) {
+    uint32_t eastGhostWord = ( board->width + 1 ) >> ( ( board->layout == LAYOUT_BYTES ) ? 3 : 6 );
+
+    return ( word == 0 || word >= eastGhostWord ) ? words[word] & BoardCellMask( board, word ) : words[word];
+}
+
+/* makes count cells alive starting at ( row, col ), a word at a time */
+void BoardSetRun( struct board_t *, uint32_t, uint32_t, uint32_t );
+
+/* Makes each cell of rows [ rowBegin, rowEnd ) and columns [ colBegin, colEnd )
+   alive with the given percentage as its chance, drawn from the seed, its
+   row and its column only. */
+void BoardFillRandom( struct board_t *, uint64_t, unsigned, uint32_t, uint32_t, uint32_t, uint32_t );
+
+/* Allocates an empty board, aborting when the size is invalid or the memory
+   is not available. */
+void BoardAllocate( struct board_t *, uint32_t, uint32_t, enum cellLayout_t );
+void BoardFree( struct board_t * );
+size_t BoardBytes( const struct board_t * );
+
+void BoardClear( struct board_t * );
+uint64_t BoardPopulation( const struct board_t * );
+
+/* fills the ghost rows and columns of the board for the given boundary */
+void BoardFillHalo( struct board_t *, enum boundary_t );
+
+/* only the ghost cells at both ends of the rows [ rowBegin, rowEnd ) */
+void BoardFillRowHalo( struct board_t *, uint32_t, uint32_t, enum boundary_t );
+
+/* The bit-packed kernel: steps the whole board under the rule, or only the
+   tile of dst made of rows [ rowBegin, rowEnd ) and row words
+   [ wordBegin, wordEnd ), returning whether any of its cells changed and
+   counting the tile into the statistics when they are given. The halo of
+   src must have been filled first. */
+void BoardStep( const struct rule_t *, const struct board_t *, struct board_t * );
+int BoardStepTile( const struct rule_t *, const struct board_t *, struct board_t *,
+                   uint32_t, uint32_t, uint32_t, uint32_t, struct tileStats_t * );
+
+#endif
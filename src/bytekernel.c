@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "bytekernel.h"
+#include "stats.h"
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#define BYTE_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+/* the positions of the cells in a tile, the ghost cells left out */
+static inline void GetSpan( const struct board_t * board, uint32_t wordBegin, uint32_t wordEnd,
+                            uint32_t * begin, uint32_t * end ) {
+    *begin = ( wordBegin > 0 ) ? wordBegin * 8 : 1;
+    *end = ( wordEnd * 8 < board->width + 1 ) ? wordEnd * 8 : board->width + 1;
+}
+
+static inline uint8_t StepSpan( const struct rule_t * rule, const uint8_t * north, const uint8_t * middle, const uint8_t * south,
+                                uint8_t * next, uint32_t begin, uint32_t end, struct tileStats_t * stats ) {
+    uint8_t changed = 0;
+    uint64_t births = 0, deaths = 0;
+
+    for ( uint32_t position = begin; position < end; position++ ) {
+        unsigned neighbours = north[position - 1] + north[position] + north[position + 1] +
+                              middle[position - 1] + middle[position + 1] +
+                              south[position - 1] + south[position] + south[position + 1];
+
+        next[position] = rule->next[middle[position]][neighbours];
+        changed |= next[position] ^ middle[position];
+        births += next[position] & ~middle[position];
+        deaths += middle[position] & ~next[position];
+    }
+
+    if ( stats != NULL ) {
+        stats->births += births;
+        stats->deaths += deaths;
+    }
+
+    return changed;
+}
+
+int ByteStepTileScalar( const struct rule_t * rule, const struct board_t * src, struct board_t * dst,
+                        uint32_t rowBegin, uint32_t rowEnd, uint32_t wordBegin, uint32_t wordEnd, struct tileStats_t * stats ) {
+    uint32_t begin, end;
+    uint8_t  changed = 0;
+
+    GetSpan( src, wordBegin, wordEnd, &begin, &end );
+    for ( uint32_t row = rowBegin; row < rowEnd; row++ ) {
+        changed |= StepSpan( rule, BoardRowBytes( src, (int64_t) row - 1 ), BoardRowBytes( src, row ),
+                             BoardRowBytes( src, (int64_t) row + 1 ), BoardRowBytes( dst, row ), begin, end, stats );
+
+        if ( stats != NULL ) {
+            StatsAddBounds( stats, dst, row, BoardRow( dst, row ), wordBegin, wordEnd );
+        }
+    }
+
+    return changed != 0;
+}
+
+#ifdef BYTE_KERNEL_X86
+
+__attribute__(( target( "sse2" ) ))
+int ByteStepTileSse2( const struct rule_t * rule, const struct board_t * src, struct board_t * dst,
+                      uint32_t rowBegin, uint32_t rowEnd, uint32_t wordBegin, uint32_t wordEnd, struct tileStats_t * stats ) {
+    __m128i  birth[9], survive[9];
+    __m128i  changed = _mm_setzero_si128();
+    __m128i  births = _mm_setzero_si128(), deaths = _mm_setzero_si128();
+    uint8_t  tailChanged = 0;
+    uint32_t begin, end;
+
+    GetSpan( src, wordBegin, wordEnd, &begin, &end );
+
+    /* without a byte shuffle the table becomes one compare per neighbour count */
+    for ( int neighbours = 0; neighbours < 9; neighbours++ ) {
+        birth[neighbours] = _mm_set1_epi8( rule->next[0][neighbours] ? -1 : 0 );
+        survive[neighbours] = _mm_set1_epi8( rule->next[1][neighbours] ? -1 : 0 );
+    }
+
+    for ( uint32_t row = rowBegin; row < rowEnd; row++ ) {
+        const uint8_t * north = BoardRowBytes( src, (int64_t) row - 1 );
+        const uint8_t * middle = BoardRowBytes( src, row );
+        const uint8_t * south = BoardRowBytes( src, (int64_t) row + 1 );
+        uint8_t * next = BoardRowBytes( dst, row );
+        uint32_t col;
+
+        for ( col = begin; col + 16 <= end; col += 16 ) {
+            __m128i sum = _mm_add_epi8(
+                _mm_add_epi8( _mm_add_epi8( _mm_loadu_si128( (const __m128i *) ( north + col - 1 ) ),
+                                            _mm_loadu_si128( (const __m128i *) ( north + col ) ) ),
+                              _mm_add_epi8( _mm_loadu_si128( (const __m128i *) ( north + col + 1 ) ),
+                                            _mm_loadu_si128( (const __m128i *) ( middle + col - 1 ) ) ) ),
+                _mm_add_epi8( _mm_add_epi8( _mm_loadu_si128( (const __m128i *) ( middle + col + 1 ) ),
+                                            _mm_loadu_si128( (const __m128i *) ( south + col - 1 ) ) ),
+                              _mm_add_epi8( _mm_loadu_si128( (const __m128i *) ( south + col ) ),
+                                            _mm_loadu_si128( (const __m128i *) ( south + col + 1 ) ) ) ) );
+            __m128i alive = _mm_cmpgt_epi8( _mm_loadu_si128( (const __m128i *) ( middle + col ) ), _mm_setzero_si128() );
+            __m128i born = _mm_setzero_si128(), survived = _mm_setzero_si128();
+
+            for ( int neighbours = 0; neighbours < 9; neighbours++ ) {
+                __m128i match = _mm_cmpeq_epi8( sum, _mm_set1_epi8( neighbours ) );
+
+                born = _mm_or_si128( born, _mm_and_si128( match, birth[neighbours] ) );
+                survived = _mm_or_si128( survived, _mm_and_si128( match, survive[neighbours] ) );
+            }
+
+            __m128i state = _mm_and_si128( _mm_or_si128( _mm_and_si128( alive, survived ), _mm_andnot_si128( alive, born ) ),
+                                           _mm_set1_epi8( 1 ) );
+            _mm_storeu_si128( (__m128i *) ( next + col ), state );
+            changed = _mm_or_si128( changed, _mm_xor_si128( state, _mm_loadu_si128( (const __m128i *) ( middle + col ) ) ) );
+
+            /* the cells are bytes of 0 or 1, summed eight at a time */
+            if ( stats != NULL ) {
+                __m128i before = _mm_loadu_si128( (const __m128i *) ( middle + col ) );
+
+                births = _mm_add_epi64( births, _mm_sad_epu8( _mm_andnot_si128( before, state ), _mm_setzero_si128() ) );
+                deaths = _mm_add_epi64( deaths, _mm_sad_epu8( _mm_andnot_si128( state, before ), _mm_setzero_si128() ) );
+            }
+        }
+
+        /* the cells left over are fewer than a vector */
+        tailChanged |= StepSpan( rule, north, middle, south, next, col, end, stats );
+
+        if ( stats != NULL ) {
+            StatsAddBounds( stats, dst, row, BoardRow( dst, row ), wordBegin, wordEnd );
+        }
+    }
+
+    if ( stats != NULL ) {
+        stats->births += (uint64_t) _mm_cvtsi128_si64( births ) + (uint64_t) _mm_cvtsi128_si64( _mm_unpackhi_epi64( births, births ) );
+        stats->deaths += (uint64_t) _mm_cvtsi128_si64( deaths ) + (uint64_t) _mm_cvtsi128_si64( _mm_unpackhi_epi64( deaths, deaths ) );
+    }
+
+    return tailChanged != 0 || _mm_movemask_epi8( _mm_cmpeq_epi8( changed, _mm_setzero_si128() ) ) != 0xffff;
+}
+
+__attribute__(( target( "avx2" ) ))
+int ByteStepTileAvx2( const struct rule_t * rule, const struct board_t * src, struct board_t * dst,
+                      uint32_t rowBegin, uint32_t rowEnd, uint32_t wordBegin, uint32_t wordEnd, struct tileStats_t * stats ) {
+    __m256i  changed = _mm256_setzero_si256();
+    __m256i  births = _mm256_setzero_si256(), deaths = _mm256_setzero_si256();
+    uint8_t  tailChanged = 0;
+    uint8_t  tables[2][16] = { { 0 } }; /* the rule padded to a whole shuffle */
+    uint32_t begin, end;
+
+    memcpy( tables[0], rule->next[0], sizeof ( rule->next[0] ) );
+    memcpy( tables[1], rule->next[1], sizeof ( rule->next[1] ) );
+
+    /* the shuffle looks up within each 128-bit lane, so both lanes get the table */
+    __m256i birth = _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i *) tables[0] ) );
+    __m256i survive = _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i *) tables[1] ) );
+
+    GetSpan( src, wordBegin, wordEnd, &begin, &end );
+
+    for ( uint32_t row = rowBegin; row < rowEnd; row++ ) {
+        const uint8_t * north = BoardRowBytes( src, (int64_t) row - 1 );
+        const uint8_t * middle = BoardRowBytes( src, row );
+        const uint8_t * south = BoardRowBytes( src, (int64_t) row + 1 );
+        uint8_t * next = BoardRowBytes( dst, row );
+        uint32_t col;
+
+        for ( col = begin; col + 32 <= end; col += 32 ) {
+            __m256i sum = _mm256_add_epi8(
+                _mm256_add_epi8( _mm256_add_epi8( _mm256_loadu_si256( (const __m256i *) ( north + col - 1 ) ),
+                                                  _mm256_loadu_si256( (const __m256i *) ( north + col ) ) ),
+                                 _mm256_add_epi8( _mm256_loadu_si256( (const __m256i *) ( north + col + 1 ) ),
+                                                  _mm256_loadu_si256( (const __m256i *) ( middle + col - 1 ) ) ) ),
+                _mm256_add_epi8( _mm256_add_epi8( _mm256_loadu_si256( (const __m256i *) ( middle + col + 1 ) ),
+                                                  _mm256_loadu_si256( (const __m256i *) ( south + col - 1 ) ) ),
+                                 _mm256_add_epi8( _mm256_loadu_si256( (const __m256i *) ( south + col ) ),
+                                                  _mm256_loadu_si256( (const __m256i *) ( south + col + 1 ) ) ) ) );
+            __m256i alive = _mm256_sub_epi8( _mm256_setzero_si256(),
+                                             _mm256_loadu_si256( (const __m256i *) ( middle + col ) ) );
+
+            __m256i state = _mm256_blendv_epi8( _mm256_shuffle_epi8( birth, sum ),
+                                                _mm256_shuffle_epi8( survive, sum ), alive );
+            _mm256_storeu_si256( (__m256i *) ( next + col ), state );
+            changed = _mm256_or_si256( changed, _mm256_xor_si256( state, _mm256_loadu_si256( (const __m256i *) ( middle + col ) ) ) );
+
+            if ( stats != NULL ) {
+                __m256i before = _mm256_loadu_si256( (const __m256i *) ( middle + col ) );
+
+                births = _mm256_add_epi64( births, _mm256_sad_epu8( _mm256_andnot_si256( before, state ), _mm256_setzero_si256() ) );
+                deaths = _mm256_add_epi64( deaths, _mm256_sad_epu8( _mm256_andnot_si256( state, before ), _mm256_setzero_si256() ) );
+            }
+        }
+
+        /* the cells left over are fewer than a vector */
+        tailChanged |= StepSpan( rule, north, middle, south, next, col, end, stats );
+
+        if ( stats != NULL ) {
+            StatsAddBounds( stats, dst, row, BoardRow( dst, row ), wordBegin, wordEnd );
+        }
+    }
+
+    if ( stats != NULL ) {
+        uint64_t sums[8];
+
+        _mm256_storeu_si256( (__m256i *) sums, births );
+        _mm256_storeu_si256( (__m256i *) ( sums + 4 ), deaths );
+        stats->births += sums[0] + sums[1] + sums[2] + sums[3];
+        stats->deaths += sums[4] + sums[5] + sums[6] + sums[7];
+    }
+
+    return tailChanged != 0 || !_mm256_testz_si256( changed, changed );
+}
+
+int CpuHasSse2( void ) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports( "sse2" );
+}
+
+int CpuHasAvx2( void ) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports( "avx2" );
+}
+
+#else
+
+int ByteStepTileSse2( const struct rule_t * rule, const struct board_t * src, struct board_t * dst,
+                      uint32_t rowBegin, uint32_t rowEnd, uint32_t wordBegin, uint32_t wordEnd, struct tileStats_t * stats ) {
+    return ByteStepTileScalar( rule, src, dst, rowBegin, rowEnd, wordBegin, wordEnd, stats );
+}
+
+int ByteStepTileAvx2( const struct rule_t * rule, const struct board_t * src, struct board_t * dst,
+                      uint32_t rowBegin, uint32_t rowEnd, uint32_t wordBegin, uint32_t wordEnd, struct tileStats_t * stats ) {
+    return ByteStepTileScalar( rule, src, dst, rowBegin, rowEnd, wordBegin, wordEnd, stats );
+}
+
+int CpuHasSse2( void ) {
+    return 0;
+}
+
+int CpuHasAvx2( void ) {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BYTEKERNEL_H
+#define BYTEKERNEL_H
+
+/* Steppers for the byte-per-cell layout: the neighbour count is the sum of
+   the three rows shifted by one cell either way, and the next state is
+   looked up from it in the rule table without branches. The vector versions
+   only exist on x86 and must only be called when the processor supports
+   them. */
+
+#include <stdint.h>
+
+#include "board.h"
+
+/* same contract as BoardStepTile() */
+int ByteStepTileScalar( const struct rule_t *, const struct board_t *, struct board_t *,
+                        uint32_t, uint32_t, uint32_t, uint32_t, struct tileStats_t * );
+int ByteStepTileSse2( const struct rule_t *, const struct board_t *, struct board_t *,
+                      uint32_t, uint32_t, uint32_t, uint32_t, struct tileStats_t * );
+int ByteStepTileAvx2( const struct rule_t *, const struct board_t *, struct board_t *,
+                      uint32_t, uint32_t, uint32_t, uint32_t, struct tileStats_t * );
+
+int CpuHasSse2( void );
+int CpuHasAvx2( void );
+
+#endif
@@ -0,0 +1,431 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bitrule.h"
+#include "chunks.h"
+#include "util.h"
+
+#define NO_CHUNK        UINT32_MAX
+#define INITIAL_CHUNKS  64
+#define INITIAL_SLOTS   256 /* a power of two, at least twice the chunks */
+
+/* The cells of the current generation are cells[phase], the step writes
+   the other half. Bit i of a row is the cell i columns east of the west
+   edge of the chunk. */
+struct chunk_t {
+    uint64_t cells[2][CHUNK_SIDE];
+    int32_t  x;          /* chunk coordinates, the cells start at 64 x, 64 y */
+    int32_t  y;
+    uint32_t next;       /* free list */
+};
+
+struct chunkLife_t {
+    struct chunk_t * chunks;    /* the pool */
+    uint32_t   capacity;
+    uint32_t   handedOut;       /* slots of the pool used so far */
+    uint32_t   freeList;
+    uint32_t * live;            /* the chunks in use, in no order */
+    uint32_t   liveCount;
+    uint32_t * slots;           /* open addressing by coordinates, NO_CHUNK when empty */
+    uint32_t   slotMask;
+    unsigned   phase;
+    uint64_t   generation;
+    bool       conway;
+    struct bitRule_t rule;
+};
+
+static const uint64_t gEmptyRows[CHUNK_SIDE];
+
+static inline uint32_t HashCoordinates( int32_t x, int32_t y ) {
+    uint64_t hash = ( (uint64_t) (uint32_t) x << 32 | (uint32_t) y ) * UINT64_C( 0x9E3779B97F4A7C15 );
+
+    return (uint32_t) ( hash >> 32 );
+}
+
+static inline uint32_t HomeSlot( const struct chunkLife_t * chunkLife, uint32_t chunk ) {
+    return HashCoordinates( chunkLife->chunks[chunk].x, chunkLife->chunks[chunk].y ) & chunkLife->slotMask;
+}
+
+/* the slot holding the chunk, or the empty slot where it would go */
+static uint32_t FindSlot( const struct chunkLife_t * chunkLife, int32_t x, int32_t y ) {
+    uint32_t slot = HashCoordinates( x, y ) & chunkLife->slotMask;
+
+    while ( chunkLife->slots[slot] != NO_CHUNK ) {
+        const struct chunk_t * chunk = &chunkLife->chunks[chunkLife->slots[slot]];
+
+        if ( chunk->x == x && chunk->y == y ) {
+            break;
+        }
+        slot = ( slot + 1 ) & chunkLife->slotMask;
+    }
+
+    return slot;
+}
+
+static void Rehash( struct chunkLife_t * chunkLife, uint32_t slotCount ) {
+    free( chunkLife->slots );
+    chunkLife->slots = malloc( (size_t) slotCount * sizeof ( uint32_t ) );
+    if ( chunkLife->slots == NULL ) {
+        Abort( "Out of memory for the chunk map" );
+    }
+
+    memset( chunkLife->slots, 0xFF, (size_t) slotCount * sizeof ( uint32_t ) );
+    chunkLife->slotMask = slotCount - 1;
+
+    for ( uint32_t i = 0; i < chunkLife->liveCount; i++ ) {
+        const struct chunk_t * chunk = &chunkLife->chunks[chunkLife->live[i]];
+
+        chunkLife->slots[FindSlot( chunkLife, chunk->x, chunk->y )] = chunkLife->live[i];
+    }
+}
+
+/* empties a slot, moving back the chunks after it that would no longer be
+   found past the hole */
+static void RemoveSlot( struct chunkLife_t * chunkLife, uint32_t hole ) {
+    uint32_t mask = chunkLife->slotMask;
+
+    for ( uint32_t slot = ( hole + 1 ) & mask; chunkLife->slots[slot] != NO_CHUNK; slot = ( slot + 1 ) & mask ) {
+        uint32_t home = HomeSlot( chunkLife, chunkLife->slots[slot] );
+
+        if ( ( ( slot - home ) & mask ) >= ( ( slot - hole ) & mask ) ) {
+            chunkLife->slots[hole] = chunkLife->slots[slot];
+            hole = slot;
+        }
+    }
+
+    chunkLife->slots[hole] = NO_CHUNK;
+}
+
+/* The chunk at these coordinates, taken empty from the pool if there was
+   none. The pool may move, so chunks are held by index. */
+static uint32_t GetChunk( struct chunkLife_t * chunkLife, int32_t x, int32_t y ) {
+    uint32_t slot = FindSlot( chunkLife, x, y );
+    uint32_t index;
+
+    if ( chunkLife->slots[slot] != NO_CHUNK ) {
+        return chunkLife->slots[slot];
+    }
+
+    if ( chunkLife->freeList != NO_CHUNK ) {
+        index = chunkLife->freeList;
+        chunkLife->freeList = chunkLife->chunks[index].next;
+    } else {
+        if ( chunkLife->handedOut == chunkLife->capacity ) {
+            struct chunk_t * chunks;
+            uint32_t * live;
+
+            if ( chunkLife->capacity >= NO_CHUNK / 4 ) {
+                Abort( "Too many chunks" );
+            }
+
+            chunks = realloc( chunkLife->chunks, (size_t) chunkLife->capacity * 2 * sizeof ( struct chunk_t ) );
+            live = realloc( chunkLife->live, (size_t) chunkLife->capacity * 2 * sizeof ( uint32_t ) );
+            if ( chunks == NULL || live == NULL ) {
+                Abort( "Out of memory for the chunks" );
+            }
+            chunkLife->chunks = chunks;
+            chunkLife->live = live;
+            chunkLife->capacity *= 2;
+
+            /* the map stays at most half full */
+            Rehash( chunkLife, chunkLife->capacity * 2 );
+            slot = FindSlot( chunkLife, x, y );
+        }
+        index = chunkLife->handedOut++;
+    }
+
+    memset( chunkLife->chunks[index].cells, 0, sizeof ( chunkLife->chunks[index].cells ) );
+    chunkLife->chunks[index].x = x;
+    chunkLife->chunks[index].y = y;
+    chunkLife->slots[slot] = index;
+    chunkLife->live[chunkLife->liveCount++] = index;
+    return index;
+}
+
+/* the rows of the current generation of a chunk, all empty if it has none */
+static const uint64_t * GetRows( const struct chunkLife_t * chunkLife, int32_t x, int32_t y ) {
+    uint32_t chunk = chunkLife->slots[FindSlot( chunkLife, x, y )];
+
+    return ( chunk == NO_CHUNK ) ? gEmptyRows : chunkLife->chunks[chunk].cells[chunkLife->phase];
+}
+
+static void ReleaseChunk( struct chunkLife_t * chunkLife, uint32_t index ) {
+    struct chunk_t * chunk = &chunkLife->chunks[index];
+
+    RemoveSlot( chunkLife, FindSlot( chunkLife, chunk->x, chunk->y ) );
+    chunk->next = chunkLife->freeList;
+    chunkLife->freeList = index;
+}
+
+static inline bool IsEmpty( const uint64_t * rows ) {
+    uint64_t any = 0;
+
+    for ( unsigned row = 0; row < CHUNK_SIDE; row++ ) {
+        any |= rows[row];
+    }
+
+    return any == 0;
+}
+
+/* the next state of a row, its neighbour count planes added up from the two
+   bit sums of the three cells above and below and of the two beside */
+static inline __attribute__(( always_inline )) uint64_t NextRow( const struct bitRule_t * rule, bool conway,
+                                uint64_t middle, uint64_t northOnes, uint64_t northTwos, uint64_t sideOnes, uint64_t sideTwos,
+                                uint64_t southOnes, uint64_t southTwos ) {
+    uint64_t ones, carryOnes, twosPartial, carryTwos, twos, carryFours;
+
+    FullAdd( northOnes, sideOnes, southOnes, &ones, &carryOnes );
+    FullAdd( northTwos, sideTwos, southTwos, &twosPartial, &carryTwos );
+    HalfAdd( twosPartial, carryOnes, &twos, &carryFours );
+
+    return BitRuleNext( rule, conway, middle, ones, twos, carryTwos ^ carryFours, carryTwos & carryFours );
+}
+
+/* Writes the next generation of a chunk. Its rows are framed by the edge
+   rows and columns of the eight chunks around it, row 0 of the frame being
+   the row above the chunk. Conway is a constant when inlined, as for the
+   board. */
+static inline __attribute__(( always_inline )) void StepChunk( struct chunkLife_t * chunkLife, struct chunk_t * chunk,
+                                                             const struct bitRule_t * rule, bool conway ) {
+    int32_t x = chunk->x, y = chunk->y;
+    const uint64_t * west = GetRows( chunkLife, x - 1, y );
+    const uint64_t * east = GetRows( chunkLife, x + 1, y );
+    const uint64_t * middle = chunk->cells[chunkLife->phase];
+    uint64_t * next = chunk->cells[chunkLife->phase ^ 1];
+    uint64_t rows[CHUNK_SIDE + 2], westRows[CHUNK_SIDE + 2], eastRows[CHUNK_SIDE + 2];
+    uint64_t tripleOnes[CHUNK_SIDE + 2], tripleTwos[CHUNK_SIDE + 2];
+
+    rows[0] = GetRows( chunkLife, x, y - 1 )[CHUNK_SIDE - 1];
+    westRows[0] = GetRows( chunkLife, x - 1, y - 1 )[CHUNK_SIDE - 1];
+    eastRows[0] = GetRows( chunkLife, x + 1, y - 1 )[CHUNK_SIDE - 1];
+    rows[CHUNK_SIDE + 1] = GetRows( chunkLife, x, y + 1 )[0];
+    westRows[CHUNK_SIDE + 1] = GetRows( chunkLife, x - 1, y + 1 )[0];
+    eastRows[CHUNK_SIDE + 1] = GetRows( chunkLife, x + 1, y + 1 )[0];
+    memcpy( rows + 1, middle, CHUNK_SIDE * sizeof ( uint64_t ) );
+    memcpy( westRows + 1, west, CHUNK_SIDE * sizeof ( uint64_t ) );
+    memcpy( eastRows + 1, east, CHUNK_SIDE * sizeof ( uint64_t ) );
+
+    /* the west and east neighbours of every cell, the last column of the
+       chunk to the west and the first of the one to the east coming in */
+    for ( unsigned row = 0; row < CHUNK_SIDE + 2; row++ ) {
+        uint64_t fromWest = ( rows[row] << 1 ) | ( westRows[row] >> 63 );
+        uint64_t fromEast = ( rows[row] >> 1 ) | ( eastRows[row] << 63 );
+
+        FullAdd( fromWest, rows[row], fromEast, &tripleOnes[row], &tripleTwos[row] );
+        westRows[row] = fromWest;
+        eastRows[row] = fromEast;
+    }
+
+    for ( unsigned row = 1; row <= CHUNK_SIDE; row++ ) {
+        uint64_t sideOnes, sideTwos;
+
+        HalfAdd( westRows[row], eastRows[row], &sideOnes, &sideTwos );
+        next[row - 1] = NextRow( rule, conway, rows[row], tripleOnes[row - 1], tripleTwos[row - 1],
+                                 sideOnes, sideTwos, tripleOnes[row + 1], tripleTwos[row + 1] );
+    }
+}
+
+/* Takes the chunks around a chunk that its edge cells can give birth in.
+   May move the pool. */
+static void Expand( struct chunkLife_t * chunkLife, uint32_t index ) {
+    const uint64_t * rows = chunkLife->chunks[index].cells[chunkLife->phase];
+    int32_t x = chunkLife->chunks[index].x, y = chunkLife->chunks[index].y;
+    uint64_t westColumn = 0, eastColumn = 0;
+    uint64_t north = rows[0], south = rows[CHUNK_SIDE - 1];
+
+    for ( unsigned row = 0; row < CHUNK_SIDE; row++ ) {
+        westColumn |= rows[row] & 1;
+        eastColumn |= rows[row] >> 63;
+    }
+
+    /* taking a chunk may move the pool, and rows with it */
+    if ( north ) {
+        GetChunk( chunkLife, x, y - 1 );
+    }
+    if ( south ) {
+        GetChunk( chunkLife, x, y + 1 );
+    }
+    if ( westColumn ) {
+        GetChunk( chunkLife, x - 1, y );
+    }
+    if ( eastColumn ) {
+        GetChunk( chunkLife, x + 1, y );
+    }
+    if ( north & 1 ) {
+        GetChunk( chunkLife, x - 1, y - 1 );
+    }
+    if ( north >> 63 ) {
+        GetChunk( chunkLife, x + 1, y - 1 );
+    }
+    if ( south & 1 ) {
+        GetChunk( chunkLife, x - 1, y + 1 );
+    }
+    if ( south >> 63 ) {
+        GetChunk( chunkLife, x + 1, y + 1 );
+    }
+}
+
+static void Step( struct chunkLife_t * chunkLife ) {
+    uint32_t count = chunkLife->liveCount, kept = 0;
+
+    for ( uint32_t i = 0; i < count; i++ ) {
+        Expand( chunkLife, chunkLife->live[i] );
+    }
+
+    for ( uint32_t i = 0; i < chunkLife->liveCount; i++ ) {
+        if ( chunkLife->conway ) {
+            StepChunk( chunkLife, &chunkLife->chunks[chunkLife->live[i]], NULL, true );
+        } else {
+            StepChunk( chunkLife, &chunkLife->chunks[chunkLife->live[i]], &chunkLife->rule, false );
+        }
+    }
+    chunkLife->phase ^= 1;
+    chunkLife->generation++;
+
+    for ( uint32_t i = 0; i < chunkLife->liveCount; i++ ) {
+        uint32_t index = chunkLife->live[i];
+
+        if ( IsEmpty( chunkLife->chunks[index].cells[chunkLife->phase] ) ) {
+            ReleaseChunk( chunkLife, index );
+        } else {
+            chunkLife->live[kept++] = index;
+        }
+    }
+    chunkLife->liveCount = kept;
+}
+
+struct chunkLife_t * ChunkLifeCreate( const struct rule_t * rule ) {
+    struct chunkLife_t * chunkLife = calloc( 1, sizeof ( *chunkLife ) );
+
+    if ( chunkLife == NULL ) {
+        Abort( "Cannot create the chunk universe" );
+    }
+
+    chunkLife->capacity = INITIAL_CHUNKS;
+    chunkLife->chunks = malloc( (size_t) INITIAL_CHUNKS * sizeof ( struct chunk_t ) );
+    chunkLife->live = malloc( (size_t) INITIAL_CHUNKS * sizeof ( uint32_t ) );
+    if ( chunkLife->chunks == NULL || chunkLife->live == NULL ) {
+        Abort( "Cannot create the chunk universe" );
+    }
+
+    chunkLife->freeList = NO_CHUNK;
+    chunkLife->conway = RuleIsConway( rule );
+    CompileBitRule( rule, &chunkLife->rule );
+    Rehash( chunkLife, INITIAL_SLOTS );
+    return chunkLife;
+}
+
+void ChunkLifeDestroy( struct chunkLife_t * chunkLife ) {
+    free( chunkLife->chunks );
+    free( chunkLife->live );
+    free( chunkLife->slots );
+    free( chunkLife );
+}
+
+void ChunkLifeLoadBoard( struct chunkLife_t * chunkLife, const struct board_t * board ) {
+    for ( uint32_t i = 0; i < chunkLife->liveCount; i++ ) {
+        ReleaseChunk( chunkLife, chunkLife->live[i] );
+    }
+    chunkLife->liveCount = 0;
+    chunkLife->phase = 0;
+    chunkLife->generation = 0;
+
+    for ( uint32_t row = 0; row < board->height; row++ ) {
+        for ( uint32_t col = 0; col < board->width; col += CHUNK_SIDE ) {
+            uint64_t cells = 0;
+
+            for ( uint32_t bit = 0; bit < CHUNK_SIDE && col + bit < board->width; bit++ ) {
+                cells |= (uint64_t) BoardGetCell( board, row, col + bit ) << bit;
+            }
+
+            if ( cells != 0 ) {
+                uint32_t chunk = GetChunk( chunkLife, (int32_t) ( col / CHUNK_SIDE ), (int32_t) ( row / CHUNK_SIDE ) );
+
+                chunkLife->chunks[chunk].cells[0][row % CHUNK_SIDE] = cells;
+            }
+        }
+    }
+}
+
+void ChunkLifeAdvance( struct chunkLife_t * chunkLife, uint64_t generations ) {
+    while ( generations-- > 0 ) {
+        Step( chunkLife );
+    }
+}
+
+uint64_t ChunkLifeGeneration( const struct chunkLife_t * chunkLife ) {
+    return chunkLife->generation;
+}
+
+uint64_t ChunkLifePopulation( const struct chunkLife_t * chunkLife ) {
+    uint64_t population = 0;
+
+    for ( uint32_t i = 0; i < chunkLife->liveCount; i++ ) {
+        const uint64_t * rows = chunkLife->chunks[chunkLife->live[i]].cells[chunkLife->phase];
+
+        for ( unsigned row = 0; row < CHUNK_SIDE; row++ ) {
+            population += __builtin_popcountll( rows[row] );
+        }
+    }
+
+    return population;
+}
+
+int ChunkLifeBoundingBox( const struct chunkLife_t * chunkLife, struct boundingBox_t * box ) {
+    struct boundingBox_t found = { .left = INT64_MAX, .top = INT64_MAX, .right = INT64_MIN, .bottom = INT64_MIN };
+
+    /* only chunks with live cells are kept between steps */
+    for ( uint32_t i = 0; i < chunkLife->liveCount; i++ ) {
+        const struct chunk_t * chunk = &chunkLife->chunks[chunkLife->live[i]];
+        const uint64_t * rows = chunk->cells[chunkLife->phase];
+        int64_t left = (int64_t) chunk->x * CHUNK_SIDE, top = (int64_t) chunk->y * CHUNK_SIDE;
+        unsigned first = CHUNK_SIDE, last = 0;
+        uint64_t columns = 0;
+
+        for ( unsigned row = 0; row < CHUNK_SIDE; row++ ) {
+            if ( rows[row] != 0 ) {
+                first = ( row < first ) ? row : first;
+                last = row;
+                columns |= rows[row];
+            }
+        }
+
+        found.left = ( left + __builtin_ctzll( columns ) < found.left ) ? left + __builtin_ctzll( columns ) : found.left;
+        found.right = ( left + 63 - __builtin_clzll( columns ) > found.right ) ? left + 63 - __builtin_clzll( columns ) : found.right;
+        found.top = ( top + first < found.top ) ? top + first : found.top;
+        found.bottom = ( top + last > found.bottom ) ? top + last : found.bottom;
+    }
+
+    if ( chunkLife->liveCount == 0 ) {
+        return 0;
+    }
+
+    *box = found;
+    return 1;
+}
+
+uint32_t ChunkLifeChunkCount( const struct chunkLife_t * chunkLife ) {
+    return chunkLife->liveCount;
+}
+
+size_t ChunkLifeMemory( const struct chunkLife_t * chunkLife ) {
+    return sizeof ( *chunkLife ) + (size_t) chunkLife->capacity * ( sizeof ( struct chunk_t ) + sizeof ( uint32_t ) ) +
+           (size_t) ( chunkLife->slotMask + 1 ) * sizeof ( uint32_t );
+}
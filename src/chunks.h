@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CHUNKS_H
+#define CHUNKS_H
+
+/* An unbounded universe of 64x64 chunks, one word per row of cells, kept in
+   a hash map by their chunk coordinates. Chunks come from a pool as cells
+   reach them and go back to it once empty, so the memory and the time of a
+   step follow the live area however far the pattern travels. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "rule.h"
+
+#define CHUNK_SIDE 64
+
+struct chunkLife_t;
+
+/* The rule must not give birth on 0 neighbours. */
+struct chunkLife_t * ChunkLifeCreate( const struct rule_t * );
+void ChunkLifeDestroy( struct chunkLife_t * );
+
+/* replaces the universe with the live cells of the board, cell ( row, col )
+   landing at x = col, y = row, and resets the generation to 0 */
+void ChunkLifeLoadBoard( struct chunkLife_t *, const struct board_t * );
+
+/* advances the universe one generation at a time */
+void ChunkLifeAdvance( struct chunkLife_t *, uint64_t );
+
+uint64_t ChunkLifeGeneration( const struct chunkLife_t * );
+uint64_t ChunkLifePopulation( const struct chunkLife_t * );
+
+/* returns 0 and leaves the box untouched when the universe is empty */
+int ChunkLifeBoundingBox( const struct chunkLife_t *, struct boundingBox_t * );
+
+uint32_t ChunkLifeChunkCount( const struct chunkLife_t * );
+size_t ChunkLifeMemory( const struct chunkLife_t * );
+
+#endif
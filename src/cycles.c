@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cycles.h"
+#include "util.h"
+
+#define HASH_MULTIPLIER UINT64_C( 0x9e3779b97f4a7c15 )
+
+/* the splitmix64 finalizer */
+static inline uint64_t Mix( uint64_t value ) {
+    value = ( value ^ ( value >> 30 ) ) * UINT64_C( 0xbf58476d1ce4e5b9 );
+    value = ( value ^ ( value >> 27 ) ) * UINT64_C( 0x94d049bb133111eb );
+    return value ^ ( value >> 31 );
+}
+
+/* what a tile adds to the board hash, so equal tiles in different places differ */
+static inline uint64_t TileKey( uint32_t tile, uint64_t tileHash ) {
+    return Mix( tileHash + ( tile + 1 ) * HASH_MULTIPLIER );
+}
+
+static inline uint64_t HashStep( uint64_t lane, uint64_t word ) {
+    lane = ( lane ^ word ) * HASH_MULTIPLIER;
+    return ( lane << 31 ) | ( lane >> 33 );
+}
+
+/* eight words of byte cells as one, each cell a bit of its byte */
+static inline uint64_t FoldBytes( const uint64_t * words ) {
+    return words[0] | words[1] << 1 | words[2] << 2 | words[3] << 3 |
+           words[4] << 4 | words[5] << 5 | words[6] << 6 | words[7] << 7;
+}
+
+/* Four chains over the words of the tile, so the multiplies overlap. A
+   multiply only carries bits upwards, the rotation brings them back down.
+   Byte cells are folded eight words at a time first. Only the words holding
+   a ghost cell are masked, outside the main loop. */
+static uint64_t HashTile( const struct tileSet_t * tiles, const struct board_t * board, uint32_t tile ) {
+    uint32_t eastGhostWord = ( board->width + 1 ) >> ( ( board->layout == LAYOUT_BYTES ) ? 3 : 6 );
+    uint32_t group = ( board->layout == LAYOUT_BYTES ) ? 32 : 4; /* words a round of the four chains takes */
+    uint64_t lane0 = 1, lane1 = 2, lane2 = 3, lane3 = 4;
+    uint32_t rowBegin, rowEnd, wordBegin, wordEnd, innerBegin, innerEnd;
+
+    TilesGetBounds( tiles, board, tile, &rowBegin, &rowEnd, &wordBegin, &wordEnd );
+    innerBegin = ( wordBegin > 0 ) ? wordBegin : 1;
+    innerEnd = ( wordEnd < eastGhostWord ) ? wordEnd : eastGhostWord;
+    innerEnd = ( innerEnd > innerBegin ) ? innerBegin + ( innerEnd - innerBegin ) / group * group : innerBegin;
+
+    for ( uint32_t row = rowBegin; row < rowEnd; row++ ) {
+        const uint64_t * words = BoardRow( board, row );
+
+        if ( board->layout == LAYOUT_BYTES ) {
+            for ( uint32_t word = innerBegin; word < innerEnd; word += 32 ) {
+                lane0 = HashStep( lane0, FoldBytes( words + word ) );
+                lane1 = HashStep( lane1, FoldBytes( words + word + 8 ) );
+                lane2 = HashStep( lane2, FoldBytes( words + word + 16 ) );
+                lane3 = HashStep( lane3, FoldBytes( words + word + 24 ) );
+            }
+        } else {
+            for ( uint32_t word = innerBegin; word < innerEnd; word += 4 ) {
+                lane0 = HashStep( lane0, words[word] );
+                lane1 = HashStep( lane1, words[word + 1] );
+                lane2 = HashStep( lane2, words[word + 2] );
+                lane3 = HashStep( lane3, words[word + 3] );
+            }
+        }
+
+        /* the words before and after the main loop, the ghost cells among them */
+        for ( uint32_t word = wordBegin; word < innerBegin; word++ ) {
+            lane0 = HashStep( lane0, BoardCells( board, words, word ) );
+        }
+        for ( uint32_t word = innerEnd; word < wordEnd; word++ ) {
+            lane0 = HashStep( lane0, BoardCells( board, words, word ) );
+        }
+    }
+
+    return Mix( lane0 ^ Mix( lane1 ^ Mix( lane2 ^ Mix( lane3 ) ) ) );
+}
+
+void CyclesCreate( struct cycleDetector_t * detector, const struct tileSet_t * tiles, const struct board_t * board,
+                   unsigned workers, uint64_t generation ) {
+    detector->tileHashes = malloc( (size_t) tiles->columns * tiles->rows * sizeof ( uint64_t ) );
+    detector->workers = aligned_alloc( _Alignof ( struct cycleWorker_t ), workers * sizeof ( struct cycleWorker_t ) );
+    if ( detector->tileHashes == NULL || detector->workers == NULL ) {
+        Abort( "Cannot allocate the cycle detection" );
+    }
+
+    detector->workerCount = workers;
+    CyclesRehash( detector, tiles, board, false, generation );
+}
+
+void CyclesFree( struct cycleDetector_t * detector ) {
+    free( detector->tileHashes );
+    free( detector->workers );
+    detector->tileHashes = NULL;
+    detector->workers = NULL;
+}
+
+void CyclesUpdateTile( struct cycleDetector_t * detector, unsigned worker, const struct tileSet_t * tiles,
+                       const struct board_t * board, uint32_t tile ) {
+    uint64_t tileHash = HashTile( tiles, board, tile );
+
+    detector->workers[worker].hashChange ^= TileKey( tile, detector->tileHashes[tile] ) ^ TileKey( tile, tileHash );
+    detector->tileHashes[tile] = tileHash;
+}
+
+bool CyclesRehash( struct cycleDetector_t * detector, const struct tileSet_t * tiles, const struct board_t * board,
+                   bool forward, uint64_t generation ) {
+    if ( detector->tileHashes == NULL ) {
+        return false;
+    }
+
+    detector->hash = 0;
+    for ( uint32_t tile = 0; tile < tiles->columns * tiles->rows; tile++ ) {
+        detector->tileHashes[tile] = HashTile( tiles, board, tile );
+        detector->hash ^= TileKey( tile, detector->tileHashes[tile] );
+    }
+
+    for ( unsigned worker = 0; worker < detector->workerCount; worker++ ) {
+        detector->workers[worker].hashChange = 0;
+    }
+
+    if ( !forward ) {
+        detector->recorded = 0;
+        detector->next = 0;
+        detector->found = false;
+        memset( detector->index, 0, sizeof ( detector->index ) );
+    }
+
+    return CyclesRecord( detector, generation );
+}
+
+/* the ring slot some generations back from the next one */
+static inline uint32_t SlotBack( const struct cycleDetector_t * detector, uint32_t back ) {
+    return ( detector->next + CYCLE_HISTORY - back ) % CYCLE_HISTORY;
+}
+
+/* The index slot holding the hash, or the free one where it goes. The
+   index is open addressed, so hashes meeting in a slot do not push each
+   other out, which would hide a cycle between them for good. */
+static uint32_t FindIndex( const struct cycleDetector_t * detector, uint64_t hash ) {
+    uint32_t slot = hash % CYCLE_INDEX;
+
+    while ( detector->index[slot] != 0 && detector->hashes[detector->index[slot] - 1] != hash ) {
+        slot = ( slot + 1 ) % CYCLE_INDEX;
+    }
+
+    return slot;
+}
+
+/* empties an index slot, moving back the entries after it that would no
+   longer be found past the hole */
+static void RemoveIndex( struct cycleDetector_t * detector, uint32_t hole ) {
+    for ( uint32_t slot = ( hole + 1 ) % CYCLE_INDEX; detector->index[slot] != 0; slot = ( slot + 1 ) % CYCLE_INDEX ) {
+        uint32_t home = detector->hashes[detector->index[slot] - 1] % CYCLE_INDEX;
+
+        if ( ( slot + CYCLE_INDEX - home ) % CYCLE_INDEX >= ( slot + CYCLE_INDEX - hole ) % CYCLE_INDEX ) {
+            detector->index[hole] = detector->index[slot];
+            hole = slot;
+        }
+    }
+
+    detector->index[hole] = 0;
+}
+
+bool CyclesRecord( struct cycleDetector_t * detector, uint64_t generation ) {
+    uint32_t indexSlot;
+    bool closed = false;
+
+    for ( unsigned worker = 0; worker < detector->workerCount; worker++ ) {
+        detector->hash ^= detector->workers[worker].hashChange;
+        detector->workers[worker].hashChange = 0;
+    }
+
+    indexSlot = FindIndex( detector, detector->hash );
+    if ( !detector->found && detector->index[indexSlot] != 0 ) {
+        uint32_t match = detector->index[indexSlot] - 1;
+        uint32_t distance = ( detector->next + CYCLE_HISTORY - match ) % CYCLE_HISTORY;
+
+        detector->found = closed = true;
+        detector->period = generation - detector->generations[match];
+        detector->start = detector->generations[match];
+
+        /* the cycle began where the generations one period apart stop matching */
+        for ( uint32_t back = 1; back + distance <= detector->recorded; back++ ) {
+            uint32_t slot = SlotBack( detector, back + distance );
+
+            if ( detector->hashes[SlotBack( detector, back )] != detector->hashes[slot] ) {
+                break;
+            }
+            detector->start = detector->generations[slot];
+        }
+    }
+
+    /* the generation about to be overwritten leaves the index too, unless
+       a later one with the same hash took its place */
+    if ( detector->recorded == CYCLE_HISTORY ) {
+        uint32_t oldSlot = FindIndex( detector, detector->hashes[detector->next] );
+
+        if ( detector->index[oldSlot] == detector->next + 1 ) {
+            RemoveIndex( detector, oldSlot );
+            indexSlot = FindIndex( detector, detector->hash );
+        }
+    } else {
+        detector->recorded++;
+    }
+
+    detector->hashes[detector->next] = detector->hash;
+    detector->generations[detector->next] = generation;
+    detector->index[indexSlot] = detector->next + 1;
+    detector->next = ( detector->next + 1 ) % CYCLE_HISTORY;
+
+    return closed;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CYCLES_H
+#define CYCLES_H
+
+/* Detects when the board starts repeating. Every tile has a hash, redone
+   by the worker that stepped it only when it changed, and the board hash
+   is the xor of the tile hashes keyed by their position, so it follows the
+   changes without a pass over the board. The board hashes of the last
+   CYCLE_HISTORY generations are kept in a ring, and a generation whose hash
+   is already there closes a cycle. */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "tiles.h"
+
+#define CYCLE_HISTORY 1024 /* generations remembered, the longest period found */
+#define CYCLE_INDEX   4096 /* slots finding a hash in the ring, a quarter full at most */
+
+/* what to do when the board repeats */
+enum cycleMode_t {
+    CYCLES_OFF,
+    CYCLES_REPORT,
+    CYCLES_STOP
+};
+
+/* the change to the board hash found by a worker, a cache line each */
+struct cycleWorker_t {
+    uint64_t hashChange;
+} __attribute__(( aligned( 64 ) ));
+
+struct cycleDetector_t {
+    uint64_t *             tileHashes; /* NULL when the detection is off */
+    struct cycleWorker_t * workers;
+    unsigned               workerCount;
+    uint64_t               hash;       /* of the whole board */
+    uint64_t               hashes[CYCLE_HISTORY];
+    uint64_t               generations[CYCLE_HISTORY];
+    uint32_t               recorded;   /* generations in the ring, up to CYCLE_HISTORY */
+    uint32_t               next;       /* the slot the next generation goes to */
+    uint16_t               index[CYCLE_INDEX]; /* a ring slot + 1 by hash, linearly probed, 0 for none */
+    bool                   found;
+    uint64_t               period;     /* in generations, once found */
+    uint64_t               start;      /* the first generation of the cycle seen */
+};
+
+/* Turns the detection on for the board as it is. */
+void CyclesCreate( struct cycleDetector_t *, const struct tileSet_t *, const struct board_t *, unsigned, uint64_t );
+void CyclesFree( struct cycleDetector_t * );
+
+/* Hashes a tile the worker has just stepped and that changed. */
+void CyclesUpdateTile( struct cycleDetector_t *, unsigned, const struct tileSet_t *, const struct board_t *, uint32_t );
+
+/* Rehashes every tile, for when the board changed without the kernel, and
+   records the generation like CyclesRecord(). The ring is emptied first
+   unless the board only went forward. */
+bool CyclesRehash( struct cycleDetector_t *, const struct tileSet_t *, const struct board_t *, bool, uint64_t );
+
+/* Adds the hash of a new generation once the workers are done, returning
+   whether it closed the first cycle. */
+bool CyclesRecord( struct cycleDetector_t *, uint64_t );
+
+#endif
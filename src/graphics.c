@@ -0,0 +1,588 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Keybindings:
+   - minus / plus      -> slow down / speed up the simulation by a quarter
+   - p                 -> pause / resume
+   - [ / ]             -> halve / double the generations per second
+   - u                 -> toggle unlimited speed (step as fast as possible)
+   - left mouse click  -> change cells color
+   - right mouse click -> change background color
+   - middle mouse drag -> pan the view
+   - arrow keys        -> pan the view
+   - mouse wheel       -> zoom in / out around the pointer
+   - page up / down    -> zoom in / out around the middle of the window
+   - home              -> show the whole board
+   - escape / q        -> quit the simulation
+   - F11               -> fullscreen
+
+   The title shows the generations and frames per second reached.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <SDL2/SDL.h>
+
+#include "graphics.h"
+#include "lod.h"
+#include "log.h"
+#include "util.h"
+
+struct SDL_Color gameColors = {
+    .r = 255,
+    .g = 127,
+    .b = 0,
+    .a = 255
+};
+
+struct SDL_Color backgroundColor = {
+    .r = 0,
+    .g = 0,
+    .b = 0,
+    .a = 255
+};
+
+const double   DEFAULT_GENERATIONS_PER_SECOND = 60;
+const double   MIN_GENERATIONS_PER_SECOND = 0.25;
+const double   MAX_GENERATIONS_PER_SECOND = 1e9;
+const double   FRAME_BUDGET_SECONDS = 0.016; /* stepping time per frame at least, when behind or unlimited */
+const double   SIMULATION_SHARE   = 0.8;   /* of the time when behind, frames are skipped to keep it */
+const double   MAX_BACKLOG_SECONDS = 0.25; /* generations due longer ago than this are given up */
+const double   FRAME_PERIOD_SECONDS = 1.0 / 120; /* frames are never drawn faster, even without vsync */
+const double   TITLE_PERIOD_SECONDS = 0.5; /* between updates of the rates in the title */
+const int      MAX_ZOOM           = 5;  /* cells of 32 pixels */
+const int      MIN_ZOOM           = -( LOD_BASE_LEVEL + LOD_MAX_LEVELS - 1 );
+const int      MAX_FIT_ZOOM       = 2;  /* the whole board is shown with cells of at most 4 pixels */
+const uint32_t MAX_WINDOW_SIDE    = 1000;
+const uint32_t MIN_GRID_PIXEL_SIZE = 3; /* smaller cells would be all gridlines */
+uint8_t        gFullscreen        = 0;
+int            gWindowWidth       = 0;
+int            gWindowHeight      = 0;
+
+/* The camera: a cell is 2^zoom pixels wide, or when the zoom is negative a
+   pixel is 2^-zoom cells wide and shows how many of them are alive. The
+   view is the cell at the top left of the window and may be off the board;
+   zoomed out, it is a multiple of the cells per pixel. */
+int            gZoom              = 0;
+int64_t        gViewRow           = 0;
+int64_t        gViewCol           = 0;
+int            gDragX             = 0; /* pointer motion not yet a whole cell */
+int            gDragY             = 0;
+uint32_t       gBoardWidth        = 0;
+uint32_t       gBoardHeight       = 0;
+struct lodPyramid_t gLod          = { 0 }; /* built the first time the view is zoomed out that far */
+
+SDL_Window *   gWindow   = NULL;
+SDL_Renderer * gRenderer = NULL;
+SDL_Texture *  gCellTexture = NULL; /* one texel per visible cell or per pixel, whichever is fewer */
+SDL_Texture *  gGridTexture = NULL; /* the grid lines over a transparent window */
+uint32_t       gGridColor   = 0;    /* the cell color the grid was drawn with */
+uint32_t       gGridSide    = 0;    /* and the cell side */
+
+/* The clock: generations fall due at the chosen rate and whole ones are
+   stepped each frame, the fraction carried over to the next. */
+uint64_t       gLastTick    = 0;
+double         gBacklog     = 0;    /* generations due and not stepped yet */
+double         gGenerationSeconds = 0; /* measured, to know how many fit in a frame */
+double         gRenderSeconds = 0;  /* measured, drawing and presenting a frame */
+uint64_t       gRateStart   = 0;    /* the rates in the title are counted from here */
+uint64_t       gRateGenerations = 0;
+uint32_t       gRateFrames  = 0;
+
+static void AdvanceFrame( struct gameOfLife_t *, double );
+static void ShowRates( const struct gameOfLife_t * );
+static void DrawGrid( void );
+static void RenderBoard( struct gameOfLife_t * );
+static void EvaluateKey( SDL_Event *, struct gameOfLife_t * );
+
+/* the run is checkpointed before leaving, if a checkpoint file was given */
+static _Noreturn void Quit( struct gameOfLife_t * gameOfLife ) {
+    FinishCheckpoint( gameOfLife );
+    DestroySimulation( gameOfLife );
+    LOG( LOG_INFO, "Arrivederci" );
+    exit( 0 );
+}
+
+static double Seconds( uint64_t ticks ) {
+    return (double) ticks / SDL_GetPerformanceFrequency();
+}
+
+/* the target rate times a factor, within the limits */
+static void ScaleRate( struct gameOfLife_t * gameOfLife, double factor ) {
+    double rate = gameOfLife->generationsPerSecond * factor;
+
+    rate = ( rate > MIN_GENERATIONS_PER_SECOND ) ? rate : MIN_GENERATIONS_PER_SECOND;
+    gameOfLife->generationsPerSecond = ( rate < MAX_GENERATIONS_PER_SECOND ) ? rate : MAX_GENERATIONS_PER_SECOND;
+    LOG( LOG_INFO, "Generations per second: %.4g", gameOfLife->generationsPerSecond );
+}
+
+/* the pixels a span of cells takes at a zoom */
+static uint64_t ScreenSpan( uint64_t cells, int zoom ) {
+    return ( zoom >= 0 ) ? cells << zoom : ( cells + ( UINT64_C( 1 ) << -zoom ) - 1 ) >> -zoom;
+}
+
+static uint32_t CellSide( void ) {
+    return ( gZoom >= 0 ) ? 1u << gZoom : 1;
+}
+
+/* the cells a span of pixels shows at the current zoom */
+static int64_t ViewSpan( int pixels ) {
+    return ( gZoom >= 0 ) ? pixels / (int64_t) CellSide() : (int64_t) pixels << -gZoom;
+}
+
+/* zoomed out, the view moves by whole pixels so every pixel covers one block */
+static int64_t AlignView( int64_t cell ) {
+    return ( gZoom >= 0 ) ? cell : (int64_t) ( (uint64_t) ( cell >> -gZoom ) << -gZoom );
+}
+
+/* Keeps the cell under the pointer where it is. */
+static void ZoomAt( int zoom, int x, int y ) {
+    double cellsPerPixel = ldexp( 1.0, -gZoom );
+    double col = gViewCol + x * cellsPerPixel, row = gViewRow + y * cellsPerPixel;
+
+    gZoom = ( zoom > MAX_ZOOM ) ? MAX_ZOOM : ( zoom < MIN_ZOOM ) ? MIN_ZOOM : zoom;
+    cellsPerPixel = ldexp( 1.0, -gZoom );
+    gViewCol = AlignView( (int64_t) floor( col - x * cellsPerPixel ) );
+    gViewRow = AlignView( (int64_t) floor( row - y * cellsPerPixel ) );
+    gDragX = gDragY = 0;
+}
+
+/* moves the board by the given pixels */
+static void Pan( int x, int y ) {
+    int side = CellSide();
+
+    gDragX += x;
+    gDragY += y;
+    gViewCol -= ( gZoom >= 0 ) ? gDragX / side : (int64_t) gDragX << -gZoom;
+    gViewRow -= ( gZoom >= 0 ) ? gDragY / side : (int64_t) gDragY << -gZoom;
+    gDragX %= side;
+    gDragY %= side;
+}
+
+/* the largest zoom up to MAX_FIT_ZOOM showing the whole board in a window
+   of MAX_WINDOW_SIDE, with the board in the middle of the window */
+static void FitBoard( void ) {
+    uint32_t longestSide = ( gBoardWidth > gBoardHeight ) ? gBoardWidth : gBoardHeight;
+
+    gZoom = MAX_FIT_ZOOM;
+    while ( gZoom > MIN_ZOOM && ScreenSpan( longestSide, gZoom ) > MAX_WINDOW_SIDE ) {
+        gZoom--;
+    }
+
+    gViewCol = AlignView( ( (int64_t) gBoardWidth - ViewSpan( gWindowWidth ) ) / 2 );
+    gViewRow = AlignView( ( (int64_t) gBoardHeight - ViewSpan( gWindowHeight ) ) / 2 );
+    gDragX = gDragY = 0;
+}
+
+void InitializeGraphics( uint32_t boardWidth, uint32_t boardHeight ) {
+    gBoardWidth = boardWidth;
+    gBoardHeight = boardHeight;
+
+    /* sized to the fitted board, then the board is centred in it */
+    FitBoard();
+    gWindowWidth = ( ScreenSpan( boardWidth, gZoom ) < MAX_WINDOW_SIDE ) ? ScreenSpan( boardWidth, gZoom ) : MAX_WINDOW_SIDE;
+    gWindowHeight = ( ScreenSpan( boardHeight, gZoom ) < MAX_WINDOW_SIDE ) ? ScreenSpan( boardHeight, gZoom ) : MAX_WINDOW_SIDE;
+    FitBoard();
+
+    if ( SDL_Init( SDL_INIT_VIDEO ) ) {
+        Abort( "Cannot initialize SDL2: {}", SDL_GetError() );
+    }
+
+    gWindow = SDL_CreateWindow( "Game of Life",
+                                SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                                gWindowWidth, gWindowHeight,
+                                SDL_WINDOW_SHOWN );
+
+    if ( gWindow == NULL ) {
+        Abort( "Cannot create window: {}", SDL_GetError() );
+    }
+
+    gRenderer = SDL_CreateRenderer( gWindow, -1, SDL_RENDERER_PRESENTVSYNC | SDL_RENDERER_ACCELERATED );
+
+    if ( gRenderer == NULL ) {
+        Abort( "Cannot create renderer: {}", SDL_GetError() );
+    }
+
+    SDL_SetRenderDrawColor( gRenderer, gameColors.r, gameColors.g, gameColors.b, gameColors.a );
+    SDL_RenderClear( gRenderer );
+
+    /* blocky cells rather than blurred ones when the texture is scaled up */
+    SDL_SetHint( SDL_HINT_RENDER_SCALE_QUALITY, "nearest" );
+    gCellTexture = SDL_CreateTexture( gRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                                      gWindowWidth, gWindowHeight );
+
+    if ( gCellTexture == NULL ) {
+        Abort( "Cannot create the cell texture: {}", SDL_GetError() );
+    }
+
+    gGridTexture = SDL_CreateTexture( gRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                      gWindowWidth, gWindowHeight );
+
+    if ( gGridTexture == NULL ) {
+        Abort( "Cannot create the grid texture: {}", SDL_GetError() );
+    }
+
+    SDL_SetTextureBlendMode( gGridTexture, SDL_BLENDMODE_BLEND );
+}
+
+void SimulationLoop( struct gameOfLife_t * gameOfLife ) {
+    SDL_Event event;
+    struct SDL_Color * colorPointer;
+
+    gLastTick = gRateStart = SDL_GetPerformanceCounter();
+
+    for ( ;; ) {
+        uint64_t frameStart = SDL_GetPerformanceCounter(), renderStart;
+        double   wait;
+
+        AdvanceFrame( gameOfLife, Seconds( frameStart - gLastTick ) );
+        gLastTick = frameStart;
+
+        /* a cycle only stops the window once, p carries on past it */
+        if ( gameOfLife->halted ) {
+            gameOfLife->halted = false;
+            gameOfLife->simulationPaused = true;
+        }
+
+        while ( SDL_PollEvent( &event ) ) {
+            switch ( event.type ) {
+            case SDL_QUIT:
+                Quit( gameOfLife );
+
+            case SDL_KEYDOWN:
+                EvaluateKey( &event, gameOfLife );
+                break;
+
+            case SDL_MOUSEBUTTONDOWN:
+                if ( event.button.button == SDL_BUTTON_MIDDLE ) {
+                    break;
+                } else if ( event.button.button == SDL_BUTTON_LEFT ) {
+                    colorPointer = &gameColors;
+                } else {
+                    colorPointer = &backgroundColor;
+                }
+                
+                colorPointer->r = random() % 256;
+                colorPointer->g = random() % 256;
+                colorPointer->b = random() % 256;
+                break;
+
+            case SDL_MOUSEMOTION:
+                if ( event.motion.state & SDL_BUTTON_MMASK ) {
+                    Pan( event.motion.xrel, event.motion.yrel );
+                }
+                break;
+
+            case SDL_MOUSEWHEEL: {
+                int x, y;
+
+                SDL_GetMouseState( &x, &y );
+                ZoomAt( gZoom + ( ( event.wheel.y > 0 ) ? 1 : -1 ), x, y );
+                break;
+            }
+            }
+        }
+
+        /* only the latest generation is shown, however many were computed */
+        renderStart = SDL_GetPerformanceCounter();
+        RenderBoard( gameOfLife );
+        gRenderSeconds = ( gRenderSeconds + Seconds( SDL_GetPerformanceCounter() - renderStart ) ) / 2;
+        gRateFrames++;
+        ShowRates( gameOfLife );
+
+        /* vsync paces the frames, this only keeps a display without it from spinning */
+        wait = FRAME_PERIOD_SECONDS - Seconds( SDL_GetPerformanceCounter() - frameStart );
+        if ( wait > 0 && !gameOfLife->unlimitedSpeed ) {
+            SDL_Delay( (uint32_t) ( wait * 1000 ) );
+        }
+    }
+}
+
+void CleanUp( void ) {
+    LodFree( &gLod );
+    SDL_DestroyTexture( gGridTexture );
+    SDL_DestroyTexture( gCellTexture );
+    SDL_DestroyRenderer( gRenderer );
+    SDL_DestroyWindow( gWindow );
+    SDL_Quit();
+}
+
+/* Steps the generations that fell due since the last frame, or at
+   unlimited speed as many as the budget allows. The budget grows with the
+   time a frame takes to draw, so when the board cannot keep up the frames
+   are drawn less often instead of the simulation slowing down, and what
+   is due beyond MAX_BACKLOG_SECONDS is given up rather than chased. */
+static void AdvanceFrame( struct gameOfLife_t * gameOfLife, double elapsed ) {
+    double   budget = gRenderSeconds * SIMULATION_SHARE / ( 1 - SIMULATION_SHARE );
+    uint64_t due = UINT64_MAX, generations, before = gameOfLife->generation, stepStart;
+
+    if ( gameOfLife->simulationPaused ) {
+        gBacklog = 0;
+        return;
+    }
+
+    if ( !gameOfLife->unlimitedSpeed ) {
+        double maxBacklog = gameOfLife->generationsPerSecond * MAX_BACKLOG_SECONDS + 1;
+
+        gBacklog += elapsed * gameOfLife->generationsPerSecond;
+        gBacklog = ( gBacklog < maxBacklog ) ? gBacklog : maxBacklog;
+        due = (uint64_t) gBacklog;
+    }
+
+    budget = ( budget > FRAME_BUDGET_SECONDS ) ? budget : FRAME_BUDGET_SECONDS;
+    generations = ( gGenerationSeconds > 0 ) ? (uint64_t) ( budget / gGenerationSeconds ) : 1;
+    generations = ( generations < due ) ? generations : due;
+    if ( generations == 0 ) {
+        return;
+    }
+
+    /* all at once, so temporal blocking can take several per pass */
+    stepStart = SDL_GetPerformanceCounter();
+    AdvanceSimulation( gameOfLife, generations );
+    if ( gameOfLife->generation > before ) {
+        double seconds = Seconds( SDL_GetPerformanceCounter() - stepStart ) / ( gameOfLife->generation - before );
+
+        gGenerationSeconds = ( gGenerationSeconds > 0 ) ? ( gGenerationSeconds + seconds ) / 2 : seconds;
+        gRateGenerations += gameOfLife->generation - before;
+    }
+
+    gBacklog = ( gameOfLife->unlimitedSpeed || gameOfLife->halted ) ? 0 : gBacklog - generations;
+}
+
+/* the generations and frames per second actually reached, in the window title */
+static void ShowRates( const struct gameOfLife_t * gameOfLife ) {
+    double seconds = Seconds( SDL_GetPerformanceCounter() - gRateStart );
+    char   title[160];
+
+    if ( seconds < TITLE_PERIOD_SECONDS ) {
+        return;
+    }
+
+    if ( gameOfLife->unlimitedSpeed ) {
+        snprintf( title, sizeof ( title ), "Game of Life - generation %llu - %.1f gen/s, unlimited - %.1f fps%s",
+                  (unsigned long long) gameOfLife->generation, gRateGenerations / seconds, gRateFrames / seconds,
+                  gameOfLife->simulationPaused ? " - paused" : "" );
+    } else {
+        snprintf( title, sizeof ( title ), "Game of Life - generation %llu - %.1f gen/s of %.4g - %.1f fps%s",
+                  (unsigned long long) gameOfLife->generation, gRateGenerations / seconds,
+                  gameOfLife->generationsPerSecond, gRateFrames / seconds,
+                  gameOfLife->simulationPaused ? " - paused" : "" );
+    }
+
+    SDL_SetWindowTitle( gWindow, title );
+    gRateStart = SDL_GetPerformanceCounter();
+    gRateGenerations = 0;
+    gRateFrames = 0;
+}
+
+static inline uint32_t PackColor( struct SDL_Color color ) {
+    return (uint32_t) color.a << 24 | (uint32_t) color.r << 16 | (uint32_t) color.g << 8 | color.b;
+}
+
+/* The grid only changes with the cell color and side, so it is drawn once
+   into a texture instead of line by line every frame. */
+static void DrawGrid( void ) {
+    uint32_t side = CellSide();
+
+    SDL_SetRenderTarget( gRenderer, gGridTexture );
+    SDL_SetRenderDrawColor( gRenderer, 0, 0, 0, 0 );
+    SDL_RenderClear( gRenderer );
+
+    SDL_SetRenderDrawColor( gRenderer, gameColors.r, gameColors.g, gameColors.b, gameColors.a );
+    for ( int line = 0; line < gWindowWidth || line < gWindowHeight; line += side ) {
+        SDL_RenderDrawLine( gRenderer, 0, line, gWindowWidth, line );
+        SDL_RenderDrawLine( gRenderer, line, 0, line, gWindowHeight );
+    }
+
+    SDL_SetRenderTarget( gRenderer, NULL );
+    gGridColor = PackColor( gameColors );
+    gGridSide = side;
+}
+
+/* the density of the side x side block from a cell, for blocks too small to be in the pyramid */
+static uint8_t CountBlock( const struct board_t * board, int64_t row, int64_t col, uint32_t side ) {
+    unsigned population = 0;
+
+    for ( int64_t y = row; y < row + side; y++ ) {
+        for ( int64_t x = col; x < col + side; x++ ) {
+            if ( y >= 0 && x >= 0 && y < board->height && x < board->width ) {
+                population += BoardGetCell( board, y, x );
+            }
+        }
+    }
+
+    return (uint8_t) ( ( population * 255 + side * side / 2 ) / ( side * side ) );
+}
+
+static void RenderBoard( struct gameOfLife_t * gameOfLife ) {
+    const struct board_t * board = &gameOfLife->board;
+    struct SDL_Color from = backgroundColor, to = gameColors;
+    uint32_t palette[256];
+    uint32_t side = CellSide();
+    struct SDL_Rect texels = {
+                              .x = 0,
+                              .y = 0,
+                              .w = ( gZoom >= 0 ) ? ( gWindowWidth + (int) side - 1 ) / (int) side : gWindowWidth,
+                              .h = ( gZoom >= 0 ) ? ( gWindowHeight + (int) side - 1 ) / (int) side : gWindowHeight
+    };
+    struct SDL_Rect cells = { .x = 0, .y = 0, .w = texels.w * (int) side, .h = texels.h * (int) side };
+    void * pixels;
+    int    pitch;
+
+    /* from the background for an empty block to the cell color for a full one */
+    for ( unsigned density = 0; density < 256; density++ ) {
+        struct SDL_Color color = {
+            .r = ( from.r * ( 255 - density ) + to.r * density ) / 255,
+            .g = ( from.g * ( 255 - density ) + to.g * density ) / 255,
+            .b = ( from.b * ( 255 - density ) + to.b * density ) / 255,
+            .a = 255
+        };
+
+        palette[density] = PackColor( color );
+    }
+
+    if ( gZoom <= -LOD_BASE_LEVEL ) {
+        if ( gLod.levels == 0 ) {
+            LodCreate( &gLod, board );
+        }
+        LodUpdate( &gLod, board, &gameOfLife->tiles );
+    }
+
+    /* one texel per cell or per pixel, written straight into the texture memory */
+    if ( SDL_LockTexture( gCellTexture, &texels, &pixels, &pitch ) ) {
+        Abort( "Cannot lock the cell texture: {}", SDL_GetError() );
+    }
+
+    for ( int y = 0; y < texels.h; y++ ) {
+        uint32_t * line = (uint32_t *) ( (uint8_t *) pixels + (size_t) y * pitch );
+
+        if ( gZoom >= 0 ) {
+            int64_t row = gViewRow + y;
+
+            for ( int x = 0; x < texels.w; x++ ) {
+                int64_t col = gViewCol + x;
+                int     alive = row >= 0 && col >= 0 && row < board->height && col < board->width &&
+                                BoardGetCell( board, row, col );
+
+                line[x] = palette[alive ? 255 : 0];
+            }
+        } else if ( gZoom <= -LOD_BASE_LEVEL ) {
+            int64_t blockRow = ( gViewRow >> -gZoom ) + y;
+
+            for ( int x = 0; x < texels.w; x++ ) {
+                line[x] = palette[LodDensity( &gLod, -gZoom, blockRow, ( gViewCol >> -gZoom ) + x )];
+            }
+        } else {
+            uint32_t block = 1u << -gZoom;
+            int64_t  row = gViewRow + (int64_t) y * block;
+
+            for ( int x = 0; x < texels.w; x++ ) {
+                line[x] = palette[CountBlock( board, row, gViewCol + (int64_t) x * block, block )];
+            }
+        }
+    }
+
+    SDL_UnlockTexture( gCellTexture );
+
+    if ( side >= MIN_GRID_PIXEL_SIZE && ( gGridColor != PackColor( gameColors ) || gGridSide != side ) ) {
+        DrawGrid();
+    }
+
+    SDL_RenderCopy( gRenderer, gCellTexture, &texels, &cells );
+    if ( side >= MIN_GRID_PIXEL_SIZE ) {
+        SDL_RenderCopy( gRenderer, gGridTexture, NULL, NULL );
+    }
+
+    /* show the changes to the screen */
+    SDL_RenderPresent( gRenderer );
+}
+
+static void EvaluateKey( SDL_Event * event, struct gameOfLife_t * gameOfLife ) {
+    switch ( event->key.keysym.sym ) {
+    case SDLK_ESCAPE:
+    case SDLK_q:
+        Quit( gameOfLife );
+
+    case SDLK_p:
+        gameOfLife->simulationPaused = !gameOfLife->simulationPaused;
+        LOG( LOG_INFO, "Pause: %d", gameOfLife->simulationPaused );
+        break;
+
+    case SDLK_LEFTBRACKET:
+        ScaleRate( gameOfLife, 0.5 );
+        break;
+
+    case SDLK_RIGHTBRACKET:
+        ScaleRate( gameOfLife, 2 );
+        break;
+
+    case SDLK_u:
+        gameOfLife->unlimitedSpeed = !gameOfLife->unlimitedSpeed;
+        LOG( LOG_INFO, "Unlimited speed: %d", gameOfLife->unlimitedSpeed );
+        break;
+
+    case SDLK_MINUS:
+    case SDLK_KP_MINUS:
+        ScaleRate( gameOfLife, 0.8 );
+        break;
+
+    case SDLK_PLUS:
+    case SDLK_EQUALS:
+    case SDLK_KP_PLUS:
+        ScaleRate( gameOfLife, 1.25 );
+        break;
+
+    case SDLK_LEFT:
+        Pan( gWindowWidth / 4, 0 );
+        break;
+
+    case SDLK_RIGHT:
+        Pan( -gWindowWidth / 4, 0 );
+        break;
+
+    case SDLK_UP:
+        Pan( 0, gWindowHeight / 4 );
+        break;
+
+    case SDLK_DOWN:
+        Pan( 0, -gWindowHeight / 4 );
+        break;
+
+    case SDLK_PAGEUP:
+        ZoomAt( gZoom + 1, gWindowWidth / 2, gWindowHeight / 2 );
+        break;
+
+    case SDLK_PAGEDOWN:
+        ZoomAt( gZoom - 1, gWindowWidth / 2, gWindowHeight / 2 );
+        break;
+
+    case SDLK_HOME:
+        FitBoard();
+        break;
+
+    case SDLK_F11:
+        if ( gFullscreen ) {
+            SDL_SetWindowFullscreen( gWindow, SDL_WINDOW_SHOWN );
+            gFullscreen = 0;
+        } else {
+            SDL_SetWindowFullscreen( gWindow, SDL_WINDOW_SHOWN | SDL_WINDOW_FULLSCREEN_DESKTOP );
+            gFullscreen = 1;
+        }
+    }
+}
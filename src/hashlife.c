@@ -0,0 +1,575 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hashlife.h"
+#include "util.h"
+
+#define NO_NODE         UINT32_MAX
+#define DEAD_CELL       0 /* the two level 0 nodes are single cells */
+#define LIVE_CELL       1
+#define FREE_LEVEL      UINT8_MAX
+#define MAX_LEVEL       62 /* the coordinates of the root must fit an int64_t */
+#define MIN_ROOT_LEVEL  3
+#define INITIAL_NODES   ( 1u << 16 )
+
+enum quadrant_t { NW, NE, SW, SE };
+
+struct hashNode_t {
+    uint32_t child[4];   /* nw, ne, sw, se */
+    uint32_t result;     /* memoized future centre, NO_NODE if not known */
+    uint32_t next;       /* hash chain, or free list for unused slots */
+    uint64_t population;
+    uint8_t  level;      /* the node is 2^level cells wide */
+    uint8_t  resultLog2; /* result lies 2^resultLog2 generations ahead */
+    uint8_t  marked;
+};
+
+struct hashLife_t {
+    struct hashNode_t * nodes;
+    uint32_t  nodeCapacity;
+    uint32_t  nodeCount;     /* slots handed out so far */
+    uint32_t  usedNodes;     /* slots holding a node */
+    uint32_t  freeList;
+    uint32_t * buckets;
+    uint32_t  bucketMask;
+    uint32_t  emptyNodes[MAX_LEVEL + 1];
+    uint32_t  root;
+    int64_t   originX;       /* board coordinates of the north west cell of the root */
+    int64_t   originY;
+    uint64_t  generation;
+    unsigned  stepLog2;      /* Result() advances by 2^stepLog2 where the level allows */
+    size_t    memoryLimit;
+    struct rule_t rule;
+};
+
+static inline uint32_t Child( const struct hashLife_t * hashLife, uint32_t node, enum quadrant_t quadrant ) {
+    return hashLife->nodes[node].child[quadrant];
+}
+
+static inline unsigned Level( const struct hashLife_t * hashLife, uint32_t node ) {
+    return hashLife->nodes[node].level;
+}
+
+static inline uint64_t Population( const struct hashLife_t * hashLife, uint32_t node ) {
+    return hashLife->nodes[node].population;
+}
+
+static inline uint32_t HashChildren( uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se ) {
+    uint64_t hash = nw * UINT64_C( 0x9E3779B97F4A7C15 );
+
+    hash = ( hash ^ ne ) * UINT64_C( 0xC2B2AE3D27D4EB4F );
+    hash = ( hash ^ sw ) * UINT64_C( 0x165667B19E3779F9 );
+    hash = ( hash ^ se ) * UINT64_C( 0x9E3779B97F4A7C15 );
+    return (uint32_t) ( hash >> 32 );
+}
+
+static void InsertInBucket( struct hashLife_t * hashLife, uint32_t index ) {
+    const uint32_t * child = hashLife->nodes[index].child;
+    uint32_t bucket = HashChildren( child[NW], child[NE], child[SW], child[SE] ) & hashLife->bucketMask;
+
+    hashLife->nodes[index].next = hashLife->buckets[bucket];
+    hashLife->buckets[bucket] = index;
+}
+
+static void Rehash( struct hashLife_t * hashLife, uint32_t bucketCount ) {
+    free( hashLife->buckets );
+    hashLife->buckets = malloc( (size_t) bucketCount * sizeof ( uint32_t ) );
+    if ( hashLife->buckets == NULL ) {
+        Abort( "Out of memory for the HashLife table" );
+    }
+
+    memset( hashLife->buckets, 0xFF, (size_t) bucketCount * sizeof ( uint32_t ) );
+    hashLife->bucketMask = bucketCount - 1;
+
+    for ( uint32_t index = LIVE_CELL + 1; index < hashLife->nodeCount; index++ ) {
+        if ( hashLife->nodes[index].level != FREE_LEVEL ) {
+            InsertInBucket( hashLife, index );
+        }
+    }
+}
+
+static uint32_t AllocateNode( struct hashLife_t * hashLife ) {
+    uint32_t index;
+
+    if ( hashLife->freeList != NO_NODE ) {
+        index = hashLife->freeList;
+        hashLife->freeList = hashLife->nodes[index].next;
+    } else {
+        if ( hashLife->nodeCount == hashLife->nodeCapacity ) {
+            struct hashNode_t * nodes;
+
+            if ( hashLife->nodeCapacity >= NO_NODE / 2 ) {
+                Abort( "Too many HashLife nodes" );
+            }
+
+            nodes = realloc( hashLife->nodes, (size_t) hashLife->nodeCapacity * 2 * sizeof ( *nodes ) );
+            if ( nodes == NULL ) {
+                Abort( "Out of memory for HashLife nodes" );
+            }
+
+            hashLife->nodes = nodes;
+            hashLife->nodeCapacity *= 2;
+        }
+
+        index = hashLife->nodeCount++;
+    }
+
+    hashLife->usedNodes++;
+    return index;
+}
+
+/* the unique node with these four children */
+static uint32_t Join( struct hashLife_t * hashLife, uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se ) {
+    uint32_t bucket = HashChildren( nw, ne, sw, se ) & hashLife->bucketMask;
+    struct hashNode_t * node;
+    uint32_t index;
+
+    for ( index = hashLife->buckets[bucket]; index != NO_NODE; index = hashLife->nodes[index].next ) {
+        const uint32_t * child = hashLife->nodes[index].child;
+
+        if ( child[NW] == nw && child[NE] == ne && child[SW] == sw && child[SE] == se ) {
+            return index;
+        }
+    }
+
+    index = AllocateNode( hashLife );
+    node = &hashLife->nodes[index];
+    node->child[NW] = nw;
+    node->child[NE] = ne;
+    node->child[SW] = sw;
+    node->child[SE] = se;
+    node->result = NO_NODE;
+    node->resultLog2 = 0;
+    node->marked = 0;
+    node->level = hashLife->nodes[nw].level + 1;
+    node->population = hashLife->nodes[nw].population + hashLife->nodes[ne].population +
+                       hashLife->nodes[sw].population + hashLife->nodes[se].population;
+
+    node->next = hashLife->buckets[bucket];
+    hashLife->buckets[bucket] = index;
+
+    if ( hashLife->usedNodes > hashLife->bucketMask ) {
+        Rehash( hashLife, ( hashLife->bucketMask + 1 ) * 2 );
+    }
+
+    return index;
+}
+
+static uint32_t EmptyNode( struct hashLife_t * hashLife, unsigned level ) {
+    if ( hashLife->emptyNodes[level] != NO_NODE ) {
+        return hashLife->emptyNodes[level];
+    }
+
+    for ( unsigned emptyLevel = 1; emptyLevel <= level; emptyLevel++ ) {
+        if ( hashLife->emptyNodes[emptyLevel] == NO_NODE ) {
+            uint32_t quarter = hashLife->emptyNodes[emptyLevel - 1];
+
+            hashLife->emptyNodes[emptyLevel] = Join( hashLife, quarter, quarter, quarter, quarter );
+        }
+    }
+
+    return hashLife->emptyNodes[level];
+}
+
+/* the middle half of a node, without advancing it */
+static uint32_t Centre( struct hashLife_t * hashLife, uint32_t node ) {
+    return Join( hashLife,
+                 Child( hashLife, Child( hashLife, node, NW ), SE ),
+                 Child( hashLife, Child( hashLife, node, NE ), SW ),
+                 Child( hashLife, Child( hashLife, node, SW ), NE ),
+                 Child( hashLife, Child( hashLife, node, SE ), NW ) );
+}
+
+/* one generation of the 2x2 centre of a 4x4 node */
+static uint32_t LeafResult( struct hashLife_t * hashLife, uint32_t node ) {
+    uint8_t cells[4][4];
+    uint32_t next[4];
+
+    for ( int quadrant = 0; quadrant < 4; quadrant++ ) {
+        uint32_t quarter = Child( hashLife, node, quadrant );
+
+        for ( int cell = 0; cell < 4; cell++ ) {
+            cells[( quadrant >> 1 ) * 2 + ( cell >> 1 )][( quadrant & 1 ) * 2 + ( cell & 1 )] =
+                Child( hashLife, quarter, cell ) == LIVE_CELL;
+        }
+    }
+
+    for ( int cell = 0; cell < 4; cell++ ) {
+        int row = 1 + ( cell >> 1 );
+        int col = 1 + ( cell & 1 );
+        int neighbours = 0;
+
+        for ( int dr = -1; dr <= 1; dr++ ) {
+            for ( int dc = -1; dc <= 1; dc++ ) {
+                neighbours += cells[row + dr][col + dc];
+            }
+        }
+        neighbours -= cells[row][col];
+
+        next[cell] = hashLife->rule.next[cells[row][col]][neighbours] ? LIVE_CELL : DEAD_CELL;
+    }
+
+    return Join( hashLife, next[0], next[1], next[2], next[3] );
+}
+
+/* The middle half of a node at level >= 2, 2^min( stepLog2, level - 2 )
+   generations ahead. */
+static uint32_t Result( struct hashLife_t * hashLife, uint32_t node ) {
+    unsigned level = Level( hashLife, node );
+    unsigned stepLog2 = ( hashLife->stepLog2 < level - 2 ) ? hashLife->stepLog2 : level - 2;
+    uint32_t result;
+
+    if ( hashLife->nodes[node].result != NO_NODE && hashLife->nodes[node].resultLog2 == stepLog2 ) {
+        return hashLife->nodes[node].result;
+    }
+
+    if ( Population( hashLife, node ) == 0 ) {
+        result = EmptyNode( hashLife, level - 1 );
+    } else if ( level == 2 ) {
+        result = LeafResult( hashLife, node );
+    } else {
+        uint32_t nw = Child( hashLife, node, NW ), ne = Child( hashLife, node, NE );
+        uint32_t sw = Child( hashLife, node, SW ), se = Child( hashLife, node, SE );
+        uint32_t parts[3][3];
+
+        /* nine overlapping subnodes of half the size */
+        parts[0][0] = nw;
+        parts[0][1] = Join( hashLife, Child( hashLife, nw, NE ), Child( hashLife, ne, NW ),
+                                      Child( hashLife, nw, SE ), Child( hashLife, ne, SW ) );
+        parts[0][2] = ne;
+        parts[1][0] = Join( hashLife, Child( hashLife, nw, SW ), Child( hashLife, nw, SE ),
+                                      Child( hashLife, sw, NW ), Child( hashLife, sw, NE ) );
+        parts[1][1] = Join( hashLife, Child( hashLife, nw, SE ), Child( hashLife, ne, SW ),
+                                      Child( hashLife, sw, NE ), Child( hashLife, se, NW ) );
+        parts[1][2] = Join( hashLife, Child( hashLife, ne, SW ), Child( hashLife, ne, SE ),
+                                      Child( hashLife, se, NW ), Child( hashLife, se, NE ) );
+        parts[2][0] = sw;
+        parts[2][1] = Join( hashLife, Child( hashLife, sw, NE ), Child( hashLife, se, NW ),
+                                      Child( hashLife, sw, SE ), Child( hashLife, se, SW ) );
+        parts[2][2] = se;
+
+        /* at full speed both halves of the step advance, otherwise only the second */
+        for ( int row = 0; row < 3; row++ ) {
+            for ( int col = 0; col < 3; col++ ) {
+                parts[row][col] = ( stepLog2 == level - 2 ) ? Result( hashLife, parts[row][col] )
+                                                            : Centre( hashLife, parts[row][col] );
+            }
+        }
+
+        result = Join( hashLife,
+                       Result( hashLife, Join( hashLife, parts[0][0], parts[0][1], parts[1][0], parts[1][1] ) ),
+                       Result( hashLife, Join( hashLife, parts[0][1], parts[0][2], parts[1][1], parts[1][2] ) ),
+                       Result( hashLife, Join( hashLife, parts[1][0], parts[1][1], parts[2][0], parts[2][1] ) ),
+                       Result( hashLife, Join( hashLife, parts[1][1], parts[1][2], parts[2][1], parts[2][2] ) ) );
+    }
+
+    hashLife->nodes[node].result = result;
+    hashLife->nodes[node].resultLog2 = stepLog2;
+    return result;
+}
+
+static void Mark( struct hashLife_t * hashLife, uint32_t node, int keepResults ) {
+    struct hashNode_t * current = &hashLife->nodes[node];
+
+    if ( current->marked || current->level == 0 ) {
+        return;
+    }
+
+    current->marked = 1;
+    for ( int quadrant = 0; quadrant < 4; quadrant++ ) {
+        Mark( hashLife, current->child[quadrant], keepResults );
+    }
+
+    if ( keepResults && current->result != NO_NODE ) {
+        Mark( hashLife, current->result, keepResults );
+    }
+}
+
+/* frees every node that cannot be reached from the root */
+static void CollectGarbage( struct hashLife_t * hashLife, int keepResults ) {
+    Mark( hashLife, hashLife->root, keepResults );
+    for ( unsigned level = 1; level <= MAX_LEVEL; level++ ) {
+        if ( hashLife->emptyNodes[level] != NO_NODE ) {
+            Mark( hashLife, hashLife->emptyNodes[level], keepResults );
+        }
+    }
+
+    for ( uint32_t index = LIVE_CELL + 1; index < hashLife->nodeCount; index++ ) {
+        struct hashNode_t * node = &hashLife->nodes[index];
+
+        if ( node->level == FREE_LEVEL ) {
+            continue;
+        }
+
+        if ( node->marked ) {
+            node->marked = 0;
+            if ( !keepResults ) {
+                node->result = NO_NODE;
+            }
+        } else {
+            node->level = FREE_LEVEL;
+            node->next = hashLife->freeList;
+            hashLife->freeList = index;
+            hashLife->usedNodes--;
+        }
+    }
+
+    Rehash( hashLife, hashLife->bucketMask + 1 );
+}
+
+static void CollectIfNeeded( struct hashLife_t * hashLife ) {
+    if ( HashLifeMemory( hashLife ) <= hashLife->memoryLimit ) {
+        return;
+    }
+
+    /* try to keep the memoized futures, drop them if that frees too little */
+    CollectGarbage( hashLife, 1 );
+    if ( HashLifeMemory( hashLife ) > hashLife->memoryLimit / 2 ) {
+        CollectGarbage( hashLife, 0 );
+    }
+}
+
+/* doubles the root, keeping the pattern in the middle */
+static void Expand( struct hashLife_t * hashLife ) {
+    uint32_t root = hashLife->root;
+    unsigned level = Level( hashLife, root );
+    uint32_t empty = EmptyNode( hashLife, level - 1 );
+
+    if ( level >= MAX_LEVEL ) {
+        Abort( "The HashLife universe grew too large" );
+    }
+
+    hashLife->root = Join( hashLife,
+                           Join( hashLife, empty, empty, empty, Child( hashLife, root, NW ) ),
+                           Join( hashLife, empty, empty, Child( hashLife, root, NE ), empty ),
+                           Join( hashLife, empty, Child( hashLife, root, SW ), empty, empty ),
+                           Join( hashLife, Child( hashLife, root, SE ), empty, empty, empty ) );
+
+    hashLife->originX -= INT64_C( 1 ) << ( level - 1 );
+    hashLife->originY -= INT64_C( 1 ) << ( level - 1 );
+}
+
+/* true when every live cell lies in the middle quarter of the root, far
+   enough from the middle half kept by Result() to travel for 2^( level - 3 )
+   generations */
+static int IsCentred( const struct hashLife_t * hashLife ) {
+    uint32_t root = hashLife->root;
+    uint32_t nw = Child( hashLife, Child( hashLife, root, NW ), SE );
+    uint32_t ne = Child( hashLife, Child( hashLife, root, NE ), SW );
+    uint32_t sw = Child( hashLife, Child( hashLife, root, SW ), NE );
+    uint32_t se = Child( hashLife, Child( hashLife, root, SE ), NW );
+
+    return Population( hashLife, root ) ==
+           Population( hashLife, Child( hashLife, nw, SE ) ) +
+           Population( hashLife, Child( hashLife, ne, SW ) ) +
+           Population( hashLife, Child( hashLife, sw, NE ) ) +
+           Population( hashLife, Child( hashLife, se, NW ) );
+}
+
+static uint32_t BuildFromBoard( struct hashLife_t * hashLife, const struct board_t * board,
+                                unsigned level, uint64_t row, uint64_t col ) {
+    uint64_t half;
+
+    if ( row >= board->height || col >= board->width ) {
+        return EmptyNode( hashLife, level );
+    }
+
+    if ( level == 0 ) {
+        return BoardGetCell( board, row, col ) ? LIVE_CELL : DEAD_CELL;
+    }
+
+    half = UINT64_C( 1 ) << ( level - 1 );
+    return Join( hashLife,
+                 BuildFromBoard( hashLife, board, level - 1, row, col ),
+                 BuildFromBoard( hashLife, board, level - 1, row, col + half ),
+                 BuildFromBoard( hashLife, board, level - 1, row + half, col ),
+                 BuildFromBoard( hashLife, board, level - 1, row + half, col + half ) );
+}
+
+struct hashLife_t * HashLifeCreate( size_t memoryLimit, const struct rule_t * rule ) {
+    struct hashLife_t * hashLife = calloc( 1, sizeof ( *hashLife ) );
+
+    if ( hashLife == NULL ) {
+        Abort( "Cannot create the HashLife universe" );
+    }
+
+    hashLife->nodeCapacity = INITIAL_NODES;
+    hashLife->nodes = malloc( (size_t) INITIAL_NODES * sizeof ( struct hashNode_t ) );
+    if ( hashLife->nodes == NULL ) {
+        Abort( "Cannot create the HashLife universe" );
+    }
+
+    /* the two cells are fixed and never hashed */
+    memset( hashLife->nodes, 0, 2 * sizeof ( struct hashNode_t ) );
+    hashLife->nodes[LIVE_CELL].population = 1;
+    hashLife->nodeCount = 2;
+    hashLife->usedNodes = 2;
+    hashLife->freeList = NO_NODE;
+    hashLife->memoryLimit = memoryLimit;
+    hashLife->rule = *rule;
+
+    for ( unsigned level = 0; level <= MAX_LEVEL; level++ ) {
+        hashLife->emptyNodes[level] = NO_NODE;
+    }
+    hashLife->emptyNodes[0] = DEAD_CELL;
+
+    Rehash( hashLife, INITIAL_NODES );
+    hashLife->root = EmptyNode( hashLife, MIN_ROOT_LEVEL );
+    return hashLife;
+}
+
+void HashLifeDestroy( struct hashLife_t * hashLife ) {
+    if ( hashLife == NULL ) {
+        return;
+    }
+
+    free( hashLife->nodes );
+    free( hashLife->buckets );
+    free( hashLife );
+}
+
+void HashLifeLoadBoard( struct hashLife_t * hashLife, const struct board_t * board ) {
+    unsigned level = MIN_ROOT_LEVEL;
+
+    while ( ( UINT64_C( 1 ) << level ) < board->width || ( UINT64_C( 1 ) << level ) < board->height ) {
+        level++;
+    }
+
+    hashLife->root = BuildFromBoard( hashLife, board, level, 0, 0 );
+    hashLife->originX = 0;
+    hashLife->originY = 0;
+    hashLife->generation = 0;
+}
+
+void HashLifeStepPow2( struct hashLife_t * hashLife, unsigned log2 ) {
+    int64_t offset;
+
+    /* the pattern can travel 2^log2 cells, which must stay inside the result */
+    while ( Level( hashLife, hashLife->root ) < log2 + 3 || !IsCentred( hashLife ) ) {
+        Expand( hashLife );
+    }
+
+    CollectIfNeeded( hashLife );
+
+    hashLife->stepLog2 = log2;
+    offset = INT64_C( 1 ) << ( Level( hashLife, hashLife->root ) - 2 );
+    hashLife->root = Result( hashLife, hashLife->root );
+    hashLife->originX += offset;
+    hashLife->originY += offset;
+    hashLife->generation += UINT64_C( 1 ) << log2;
+}
+
+void HashLifeAdvance( struct hashLife_t * hashLife, uint64_t generations ) {
+    for ( unsigned log2 = 0; generations != 0; log2++, generations >>= 1 ) {
+        if ( generations & 1 ) {
+            HashLifeStepPow2( hashLife, log2 );
+        }
+    }
+}
+
+uint64_t HashLifeGeneration( const struct hashLife_t * hashLife ) {
+    return hashLife->generation;
+}
+
+uint64_t HashLifePopulation( const struct hashLife_t * hashLife ) {
+    return Population( hashLife, hashLife->root );
+}
+
+/* Distance of the nearest live cell from one edge of a non empty node. The
+   near quadrants touch that edge, the far ones are half a node away; memo
+   makes shared subtrees cost only once. */
+static uint64_t EdgeDistance( const struct hashLife_t * hashLife, uint32_t node, const enum quadrant_t near[2],
+                              const enum quadrant_t far[2], uint64_t * memo ) {
+    unsigned level = Level( hashLife, node );
+    uint64_t distance = UINT64_MAX;
+
+    if ( level == 0 ) {
+        return 0;
+    }
+
+    if ( memo[node] != UINT64_MAX ) {
+        return memo[node];
+    }
+
+    for ( int i = 0; i < 2; i++ ) {
+        uint32_t quarter = Child( hashLife, node, near[i] );
+
+        if ( Population( hashLife, quarter ) > 0 ) {
+            uint64_t nearDistance = EdgeDistance( hashLife, quarter, near, far, memo );
+
+            distance = ( nearDistance < distance ) ? nearDistance : distance;
+        }
+    }
+
+    if ( distance == UINT64_MAX ) {
+        for ( int i = 0; i < 2; i++ ) {
+            uint32_t quarter = Child( hashLife, node, far[i] );
+
+            if ( Population( hashLife, quarter ) > 0 ) {
+                uint64_t farDistance = ( UINT64_C( 1 ) << ( level - 1 ) ) +
+                                       EdgeDistance( hashLife, quarter, near, far, memo );
+
+                distance = ( farDistance < distance ) ? farDistance : distance;
+            }
+        }
+    }
+
+    memo[node] = distance;
+    return distance;
+}
+
+static int64_t FindEdge( const struct hashLife_t * hashLife, const enum quadrant_t near[2],
+                         const enum quadrant_t far[2], uint64_t * memo ) {
+    memset( memo, 0xFF, (size_t) hashLife->nodeCount * sizeof ( uint64_t ) );
+    return (int64_t) EdgeDistance( hashLife, hashLife->root, near, far, memo );
+}
+
+int HashLifeBoundingBox( const struct hashLife_t * hashLife, struct boundingBox_t * box ) {
+    static const enum quadrant_t north[2] = { NW, NE }, south[2] = { SW, SE };
+    static const enum quadrant_t west[2] = { NW, SW }, east[2] = { NE, SE };
+    int64_t  last = ( INT64_C( 1 ) << Level( hashLife, hashLife->root ) ) - 1;
+    uint64_t * memo;
+
+    if ( Population( hashLife, hashLife->root ) == 0 ) {
+        return 0;
+    }
+
+    memo = malloc( (size_t) hashLife->nodeCount * sizeof ( uint64_t ) );
+    if ( memo == NULL ) {
+        Abort( "Out of memory for the HashLife bounding box" );
+    }
+
+    box->top = hashLife->originY + FindEdge( hashLife, north, south, memo );
+    box->bottom = hashLife->originY + last - FindEdge( hashLife, south, north, memo );
+    box->left = hashLife->originX + FindEdge( hashLife, west, east, memo );
+    box->right = hashLife->originX + last - FindEdge( hashLife, east, west, memo );
+
+    free( memo );
+    return 1;
+}
+
+uint32_t HashLifeNodeCount( const struct hashLife_t * hashLife ) {
+    return hashLife->usedNodes;
+}
+
+size_t HashLifeMemory( const struct hashLife_t * hashLife ) {
+    return (size_t) hashLife->usedNodes * sizeof ( struct hashNode_t ) +
+           (size_t) ( hashLife->bucketMask + 1 ) * sizeof ( uint32_t );
+}
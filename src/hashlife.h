@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HASHLIFE_H
+#define HASHLIFE_H
+
+/* HashLife: the universe is a quadtree whose identical subtrees are shared
+   through a hash table, and the future centre of every node is memoized, so
+   regular patterns can be advanced by huge powers of two at once. Unlike
+   the board the plane is unbounded. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "rule.h"
+
+struct hashLife_t;
+
+/* The memory limit is in bytes, nodes are garbage collected past it. The
+   rule must not give birth on 0 neighbours. */
+struct hashLife_t * HashLifeCreate( size_t, const struct rule_t * );
+void HashLifeDestroy( struct hashLife_t * );
+
+/* replaces the universe with the live cells of the board, cell ( row, col )
+   landing at x = col, y = row, and resets the generation to 0 */
+void HashLifeLoadBoard( struct hashLife_t *, const struct board_t * );
+
+/* advances the universe by 2^log2 generations in one step */
+void HashLifeStepPow2( struct hashLife_t *, unsigned );
+
+/* advances the universe by any number of generations, one power of two
+   per set bit */
+void HashLifeAdvance( struct hashLife_t *, uint64_t );
+
+uint64_t HashLifeGeneration( const struct hashLife_t * );
+uint64_t HashLifePopulation( const struct hashLife_t * );
+
+/* returns 0 and leaves the box untouched when the universe is empty */
+int HashLifeBoundingBox( const struct hashLife_t *, struct boundingBox_t * );
+
+uint32_t HashLifeNodeCount( const struct hashLife_t * );
+size_t HashLifeMemory( const struct hashLife_t * );
+
+#endif
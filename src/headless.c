@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+
+#include "chunks.h"
+#include "hashlife.h"
+#include "headless.h"
+#include "pattern.h"
+#include "util.h"
+
+static void PrintTiming( uint64_t generations, uint64_t elapsed, double cellsPerGeneration ) {
+    double seconds = elapsed / 1e9;
+
+    printf( "elapsed %.6f s, %.1f ns/generation, %.1f generations/s",
+            seconds,
+            generations ? (double) elapsed / generations : 0.0,
+            seconds > 0 ? generations / seconds : 0.0 );
+
+    /* meaningless for the unbounded engines, which skip most of the plane */
+    if ( cellsPerGeneration > 0 ) {
+        printf( ", %.3e cell updates/s", seconds > 0 ? generations * cellsPerGeneration / seconds : 0.0 );
+    }
+    putchar( '\n' );
+}
+
+static void PrintHashLifeState( const struct hashLife_t * hashLife ) {
+    struct boundingBox_t box;
+
+    printf( "generation %llu population %llu",
+            (unsigned long long) HashLifeGeneration( hashLife ),
+            (unsigned long long) HashLifePopulation( hashLife ) );
+
+    if ( HashLifeBoundingBox( hashLife, &box ) ) {
+        printf( " bounding box (%lld, %lld) - (%lld, %lld)",
+                (long long) box.left, (long long) box.top, (long long) box.right, (long long) box.bottom );
+    }
+
+    printf( " nodes %u\n", HashLifeNodeCount( hashLife ) );
+}
+
+static void PrintChunksState( const struct chunkLife_t * chunkLife ) {
+    struct boundingBox_t box;
+
+    printf( "generation %llu population %llu",
+            (unsigned long long) ChunkLifeGeneration( chunkLife ),
+            (unsigned long long) ChunkLifePopulation( chunkLife ) );
+
+    if ( ChunkLifeBoundingBox( chunkLife, &box ) ) {
+        printf( " bounding box (%lld, %lld) - (%lld, %lld)",
+                (long long) box.left, (long long) box.top, (long long) box.right, (long long) box.bottom );
+    }
+
+    printf( " chunks %u\n", ChunkLifeChunkCount( chunkLife ) );
+}
+
+/* with statistics on, the report comes from the counts of the last step
+   instead of a pass over the board */
+static void PrintBoardState( const struct gameOfLife_t * gameOfLife ) {
+    const struct lifeStats_t * stats = SimulationStats( gameOfLife );
+
+    if ( stats == NULL ) {
+        printf( "generation %llu population %llu\n",
+                (unsigned long long) gameOfLife->generation,
+                (unsigned long long) BoardPopulation( &gameOfLife->board ) );
+        return;
+    }
+
+    printf( "generation %llu population %llu births %llu deaths %llu",
+            (unsigned long long) stats->generation, (unsigned long long) stats->population,
+            (unsigned long long) stats->births, (unsigned long long) stats->deaths );
+
+    if ( stats->population > 0 ) {
+        printf( " bounding box (%lld, %lld) - (%lld, %lld)",
+                (long long) stats->box.left, (long long) stats->box.top,
+                (long long) stats->box.right, (long long) stats->box.bottom );
+    }
+    putchar( '\n' );
+}
+
+/* The board only provides the initial state, the universe is unbounded and
+   advances by whole reporting intervals. */
+static void RunHashLife( struct gameOfLife_t * gameOfLife, const struct options_t * options ) {
+    struct hashLife_t * hashLife;
+    uint64_t remaining = options->generations;
+    uint64_t startTime, elapsed;
+
+    /* a pattern file may have brought its own rule */
+    if ( gameOfLife->rule.next[0][0] ) {
+        Abort( "The hashlife engine cannot run rules with B0: {}", gameOfLife->rule.name );
+    }
+
+    hashLife = HashLifeCreate( options->memoryLimit, &gameOfLife->rule );
+
+    HashLifeLoadBoard( hashLife, &gameOfLife->board );
+    printf( "hashlife from a %ux%u board, rule %s, %llu generations, memory limit %llu MB\n",
+            gameOfLife->board.width, gameOfLife->board.height, gameOfLife->rule.name,
+            (unsigned long long) options->generations,
+            (unsigned long long) ( options->memoryLimit >> 20 ) );
+    PrintHashLifeState( hashLife );
+
+    startTime = NanoTime();
+    while ( remaining > 0 ) {
+        uint64_t interval = ( options->reportEvery && options->reportEvery < remaining ) ? options->reportEvery : remaining;
+
+        HashLifeAdvance( hashLife, interval );
+        remaining -= interval;
+
+        if ( remaining > 0 ) {
+            PrintHashLifeState( hashLife );
+        }
+    }
+    elapsed = NanoTime() - startTime;
+
+    printf( "final " );
+    PrintHashLifeState( hashLife );
+    printf( "memory %.1f MB\n", HashLifeMemory( hashLife ) / 1048576.0 );
+    PrintTiming( options->generations, elapsed, 0 );
+
+    HashLifeDestroy( hashLife );
+}
+
+/* As with HashLife the board only provides the initial state, but the
+   chunks step one generation at a time. */
+static void RunChunks( struct gameOfLife_t * gameOfLife, const struct options_t * options ) {
+    struct chunkLife_t * chunkLife;
+    uint64_t remaining = options->generations;
+    uint64_t startTime, elapsed;
+
+    if ( gameOfLife->rule.next[0][0] ) {
+        Abort( "The chunks engine cannot run rules with B0: {}", gameOfLife->rule.name );
+    }
+
+    chunkLife = ChunkLifeCreate( &gameOfLife->rule );
+
+    ChunkLifeLoadBoard( chunkLife, &gameOfLife->board );
+    printf( "chunks from a %ux%u board, rule %s, %llu generations\n",
+            gameOfLife->board.width, gameOfLife->board.height, gameOfLife->rule.name,
+            (unsigned long long) options->generations );
+    PrintChunksState( chunkLife );
+
+    startTime = NanoTime();
+    while ( remaining > 0 ) {
+        uint64_t interval = ( options->reportEvery && options->reportEvery < remaining ) ? options->reportEvery : remaining;
+
+        ChunkLifeAdvance( chunkLife, interval );
+        remaining -= interval;
+
+        if ( remaining > 0 ) {
+            PrintChunksState( chunkLife );
+        }
+    }
+    elapsed = NanoTime() - startTime;
+
+    printf( "final " );
+    PrintChunksState( chunkLife );
+    printf( "memory %.1f MB\n", ChunkLifeMemory( chunkLife ) / 1048576.0 );
+    PrintTiming( options->generations, elapsed, 0 );
+
+    ChunkLifeDestroy( chunkLife );
+}
+
+void RunHeadless( struct gameOfLife_t * gameOfLife, const struct options_t * options ) {
+    uint64_t initialPopulation = BoardPopulation( &gameOfLife->board );
+    uint64_t startGeneration = gameOfLife->generation;
+    uint64_t startTime, elapsed;
+
+    if ( options->engine == ENGINE_HASHLIFE ) {
+        RunHashLife( gameOfLife, options );
+        return;
+    } else if ( options->engine == ENGINE_CHUNKS ) {
+        RunChunks( gameOfLife, options );
+        return;
+    }
+
+    printf( "board %ux%u, rule %s, %s kernel, %u threads, %llu generations, initial population %llu\n",
+            gameOfLife->board.width, gameOfLife->board.height, gameOfLife->rule.name, gameOfLife->kernel->name,
+            ThreadPoolSize( gameOfLife->threadPool ),
+            (unsigned long long) options->generations,
+            (unsigned long long) initialPopulation );
+
+    startTime = NanoTime();
+    for ( uint64_t remaining = options->generations; remaining > 0 && !gameOfLife->halted; ) {
+        uint64_t interval = remaining;
+
+        /* up to the next report */
+        if ( options->reportEvery && interval > options->reportEvery - gameOfLife->generation % options->reportEvery ) {
+            interval = options->reportEvery - gameOfLife->generation % options->reportEvery;
+        }
+
+        AdvanceSimulation( gameOfLife, interval );
+        remaining -= interval;
+
+        if ( options->reportEvery && gameOfLife->generation % options->reportEvery == 0 ) {
+            PrintBoardState( gameOfLife );
+        }
+    }
+    elapsed = NanoTime() - startTime;
+
+    printf( "final population %llu at generation %llu\n",
+            (unsigned long long) BoardPopulation( &gameOfLife->board ),
+            (unsigned long long) gameOfLife->generation );
+    PrintTiming( gameOfLife->generation - startGeneration, elapsed,
+                 (double) gameOfLife->board.width * gameOfLife->board.height );
+
+    FinishCheckpoint( gameOfLife );
+
+    if ( options->outputPath != NULL ) {
+        SavePattern( options->outputPath, &gameOfLife->board, &gameOfLife->rule );
+    }
+}
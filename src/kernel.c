@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "bytekernel.h"
+#include "kernel.h"
+#include "lutkernel.h"
+#include "util.h"
+
+static int AlwaysSupported( void ) {
+    return 1;
+}
+
+static const struct lifeKernel_t gKernels[] = {
+    { "bits",         "bit-packed, 64 cells per word with a bitwise adder", LAYOUT_BITS,  AlwaysSupported, BoardStepTile },
+    { "lut",          "bit-packed, 2x2 cells at a time from a 65536 entry table", LAYOUT_BITS, AlwaysSupported, LutStepTile },
+    { "bytes-avx2",   "byte per cell, 32 cells per AVX2 vector",            LAYOUT_BYTES, CpuHasAvx2,      ByteStepTileAvx2 },
+    { "bytes-sse2",   "byte per cell, 16 cells per SSE2 vector",            LAYOUT_BYTES, CpuHasSse2,      ByteStepTileSse2 },
+    { "bytes-scalar", "byte per cell, plain C",                             LAYOUT_BYTES, AlwaysSupported, ByteStepTileScalar }
+};
+
+const struct lifeKernel_t * FindKernel( const char * name ) {
+    for ( unsigned i = 0; i < ARRAY_SIZE( gKernels, struct lifeKernel_t ); i++ ) {
+        /* the byte kernels are listed fastest first */
+        if ( strcmp( name, "bytes" ) == 0 && gKernels[i].layout == LAYOUT_BYTES && gKernels[i].isSupported() ) {
+            return &gKernels[i];
+        }
+
+        if ( strcmp( name, gKernels[i].name ) == 0 ) {
+            return &gKernels[i];
+        }
+    }
+
+    return NULL;
+}
+
+const struct lifeKernel_t * GetKernel( unsigned index ) {
+    return ( index < ARRAY_SIZE( gKernels, struct lifeKernel_t ) ) ? &gKernels[index] : NULL;
+}
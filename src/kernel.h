@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include <stdint.h>
+
+#include "board.h"
+
+/* A way of computing the next generation for one tile of the board, see
+   BoardStepTile(). Every kernel works on one cell layout and reads the halo
+   of src filled beforehand; the statistics may be NULL, and the kernel only
+   counts into them, they are cleared by the caller. */
+struct lifeKernel_t {
+    const char *      name;
+    const char *      description;
+    enum cellLayout_t layout;
+    int  ( * isSupported )( void );
+    int  ( * stepTile )( const struct rule_t *, const struct board_t *, struct board_t *,
+                         uint32_t, uint32_t, uint32_t, uint32_t, struct tileStats_t * );
+};
+
+/* The kernel with this name, or NULL. "bytes" picks the fastest byte kernel
+   the processor supports. */
+const struct lifeKernel_t * FindKernel( const char * );
+
+/* the nth kernel, NULL past the last one */
+const struct lifeKernel_t * GetKernel( unsigned );
+
+#endif
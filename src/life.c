@@ -0,0 +1,316 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "life.h"
+#include "log.h"
+#include "pattern.h"
+#include "snapshot.h"
+#include "util.h"
+
+const unsigned MAX_THREADS = 1024;
+
+struct randomFill_t {
+    struct gameOfLife_t * gameOfLife;
+    uint64_t              seed;
+    unsigned              density;
+};
+
+/* the first generation, from a snapshot, a pattern or a random soup */
+static void LoadBoard( struct gameOfLife_t * gameOfLife, const struct options_t * options, struct snapshot_t * snapshot ) {
+    if ( options->restorePath != NULL ) {
+        struct rule_t snapshotRule;
+
+        if ( !ParseRule( snapshot->header->rule, &snapshotRule ) ) {
+            Abort( "Corrupt snapshot rule: {}", options->restorePath );
+        }
+
+        if ( !options->ruleGiven ) {
+            gameOfLife->rule = snapshotRule;
+        }
+
+        SnapshotRestore( snapshot, &gameOfLife->board );
+        gameOfLife->generation = snapshot->header->generation;
+        SnapshotClose( snapshot );
+        return;
+    }
+
+    if ( options->patternPath != NULL ) {
+        struct rule_t patternRule;
+
+        if ( LoadPattern( options->patternPath, &gameOfLife->board, &patternRule ) && !options->ruleGiven ) {
+            gameOfLife->rule = patternRule;
+        }
+        return;
+    }
+
+    RandomizeSimulation( gameOfLife, options->seeded ? options->seed : (uint64_t) time( 0 ), options->density );
+}
+
+void InitializeSimulation( struct gameOfLife_t * gameOfLife, const struct options_t * options ) {
+    unsigned threads = ( options->threads > 0 ) ? options->threads : ProcessorCount();
+    uint32_t width = options->width, height = options->height;
+    struct snapshot_t snapshot;
+
+    if ( threads > MAX_THREADS ) {
+        threads = MAX_THREADS;
+    }
+
+    gameOfLife->threadPool = ThreadPoolCreate( threads );
+
+    /* a restored run keeps the size of its board */
+    if ( options->restorePath != NULL ) {
+        SnapshotOpen( options->restorePath, &snapshot );
+        width = snapshot.header->width;
+        height = snapshot.header->height;
+    }
+
+    gameOfLife->rule = options->rule;
+    gameOfLife->kernel = options->kernel;
+    BoardAllocate( &gameOfLife->board, width, height, gameOfLife->kernel->layout );
+    BoardAllocate( &gameOfLife->workBoard, width, height, gameOfLife->kernel->layout );
+    TilesCreate( &gameOfLife->tiles, &gameOfLife->board );
+    gameOfLife->temporal = (struct temporalBlocking_t) { .depth = 1 };
+    if ( options->temporalDepth > 1 ) {
+        TemporalCreate( &gameOfLife->temporal, &gameOfLife->board, options->temporalDepth, threads );
+    }
+    gameOfLife->generation = 0;
+    gameOfLife->boundary = options->boundary;
+    gameOfLife->checkpoint = (struct snapshotWriter_t) { .path = options->checkpointPath };
+    gameOfLife->checkpointEvery = options->checkpointEvery;
+    gameOfLife->stats = (struct statsCollector_t) { .tiles = NULL };
+    gameOfLife->cycles = (struct cycleDetector_t) { .tileHashes = NULL };
+    gameOfLife->cycleMode = options->cycleMode;
+    gameOfLife->halted = false;
+    gameOfLife->quiet = false;
+
+    LoadBoard( gameOfLife, options, &snapshot );
+
+    if ( options->statsPath != NULL ) {
+        StatsCreate( &gameOfLife->stats, &gameOfLife->tiles, &gameOfLife->board, gameOfLife->generation, options->statsPath );
+    }
+
+    if ( options->cycleMode != CYCLES_OFF ) {
+        CyclesCreate( &gameOfLife->cycles, &gameOfLife->tiles, &gameOfLife->board, threads, gameOfLife->generation );
+    }
+
+    LOG( LOG_DEBUG, "%ux%u board at generation %llu, rule %s, kernel %s, %u threads, %zu bytes a board",
+         width, height, (unsigned long long) gameOfLife->generation, gameOfLife->rule.name,
+         gameOfLife->kernel->name, threads, BoardBytes( &gameOfLife->board ) );
+}
+
+/* a band of rows for every worker, the cells do not depend on who draws them */
+static void FillRandomRows( void * context, unsigned worker, unsigned workers ) {
+    struct randomFill_t * fill = context;
+    struct board_t * board = &fill->gameOfLife->board;
+
+    BoardFillRandom( board, fill->seed, fill->density,
+                     (uint32_t) ( (uint64_t) board->height * worker / workers ),
+                     (uint32_t) ( (uint64_t) board->height * ( worker + 1 ) / workers ), 0, board->width );
+}
+
+void RandomizeSimulation( struct gameOfLife_t * gameOfLife, uint64_t seed, unsigned density ) {
+    struct randomFill_t fill = { .gameOfLife = gameOfLife, .seed = seed, .density = density };
+
+    ThreadPoolRun( gameOfLife->threadPool, FillRandomRows, &fill );
+
+    gameOfLife->generation = 0;
+    InvalidateSimulation( gameOfLife );
+}
+
+/* the active tiles [ begin, end ) that belong to a worker */
+static void GetShare( uint32_t tiles, unsigned worker, unsigned workers, uint32_t * begin, uint32_t * end ) {
+    *begin = (uint32_t) ( (uint64_t) tiles * worker / workers );
+    *end = (uint32_t) ( (uint64_t) tiles * ( worker + 1 ) / workers );
+}
+
+static void StepTiles( void * context, unsigned worker, unsigned workers ) {
+    struct gameOfLife_t * gameOfLife = context;
+    struct tileSet_t * tiles = &gameOfLife->tiles;
+    uint32_t begin, end, rowBegin, rowEnd, wordBegin, wordEnd;
+
+    GetShare( tiles->count, worker, workers, &begin, &end );
+    for ( uint32_t i = begin; i < end; i++ ) {
+        struct tileStats_t * stats = NULL;
+
+        /* a tile is stepped by one worker, so its counters need no locking */
+        if ( gameOfLife->stats.tiles != NULL ) {
+            stats = &gameOfLife->stats.tiles[tiles->active[i]];
+            StatsClearTile( stats );
+        }
+
+        TilesGetBounds( tiles, &gameOfLife->board, tiles->active[i], &rowBegin, &rowEnd, &wordBegin, &wordEnd );
+        tiles->changed[i] = gameOfLife->kernel->stepTile( &gameOfLife->rule, &gameOfLife->board, &gameOfLife->workBoard,
+                                                          rowBegin, rowEnd, wordBegin, wordEnd, stats );
+
+        /* hashed while it is in the cache, and only when it changed */
+        if ( tiles->changed[i] && gameOfLife->cycles.tileHashes != NULL ) {
+            CyclesUpdateTile( &gameOfLife->cycles, worker, tiles, &gameOfLife->workBoard, tiles->active[i] );
+        }
+    }
+}
+
+static void CycleFound( struct gameOfLife_t * gameOfLife ) {
+    const struct cycleDetector_t * cycles = &gameOfLife->cycles;
+
+    gameOfLife->halted = ( gameOfLife->cycleMode == CYCLES_STOP );
+    if ( gameOfLife->quiet ) {
+        return;
+    }
+
+    if ( cycles->period == 1 ) {
+        LOG( LOG_INFO, "generation %llu: the board is still since generation %llu",
+             (unsigned long long) gameOfLife->generation, (unsigned long long) cycles->start );
+    } else {
+        LOG( LOG_INFO, "generation %llu: the board repeats every %llu generations since generation %llu",
+             (unsigned long long) gameOfLife->generation, (unsigned long long) cycles->period,
+             (unsigned long long) cycles->start );
+    }
+}
+
+/* Only the tiles that changed last generation or touch one that did are
+   stepped. Every other tile is a still life or empty, and the working board
+   already holds the same cells there: it has them from two generations ago,
+   and a tile that changed since then is active now and stepped again. */
+void StepSimulation( struct gameOfLife_t * gameOfLife ) {
+    struct board_t front = gameOfLife->workBoard;
+
+    BoardFillHalo( &gameOfLife->board, gameOfLife->boundary );
+    ThreadPoolRun( gameOfLife->threadPool, StepTiles, gameOfLife );
+
+    /* the working board becomes the board, the two only trade storage */
+    gameOfLife->workBoard = gameOfLife->board;
+    gameOfLife->board = front;
+    gameOfLife->generation++;
+    if ( gameOfLife->stats.tiles != NULL ) {
+        StatsCollect( &gameOfLife->stats, &gameOfLife->tiles, gameOfLife->generation );
+    }
+    if ( gameOfLife->cycles.tileHashes != NULL && CyclesRecord( &gameOfLife->cycles, gameOfLife->generation ) ) {
+        CycleFound( gameOfLife );
+    }
+    TilesUpdate( &gameOfLife->tiles, gameOfLife->boundary );
+
+    if ( gameOfLife->checkpointEvery && gameOfLife->generation % gameOfLife->checkpointEvery == 0 ) {
+        CheckpointSimulation( gameOfLife );
+    }
+}
+
+static void StepBands( void * context, unsigned worker, unsigned workers ) {
+    struct gameOfLife_t * gameOfLife = context;
+
+    TemporalStepBands( &gameOfLife->temporal, worker, workers, gameOfLife->kernel, &gameOfLife->rule,
+                       gameOfLife->boundary, &gameOfLife->board, &gameOfLife->workBoard,
+                       gameOfLife->temporalGenerations );
+}
+
+/* Temporal blocking steps every cell, however still, so it is left to large
+   busy boards that asked for it, and the tiles are all stepped again after.
+   The kernels only see the last generation of a band, so the statistics are
+   counted once per pass with a comparison of the two boards, and the board
+   is hashed once per pass, which finds a multiple of the period. */
+void AdvanceSimulation( struct gameOfLife_t * gameOfLife, uint64_t generations ) {
+    while ( generations > 0 && !gameOfLife->halted ) {
+        uint64_t pass = ( generations < gameOfLife->temporal.depth ) ? generations : gameOfLife->temporal.depth;
+        struct board_t front = gameOfLife->workBoard;
+
+        /* stop at the next checkpoint */
+        if ( gameOfLife->checkpointEvery && pass > gameOfLife->checkpointEvery - gameOfLife->generation % gameOfLife->checkpointEvery ) {
+            pass = gameOfLife->checkpointEvery - gameOfLife->generation % gameOfLife->checkpointEvery;
+        }
+
+        if ( pass < 2 ) {
+            StepSimulation( gameOfLife );
+            generations--;
+            continue;
+        }
+
+        BoardFillHalo( &gameOfLife->board, gameOfLife->boundary );
+        gameOfLife->temporalGenerations = pass;
+        ThreadPoolRun( gameOfLife->threadPool, StepBands, gameOfLife );
+
+        gameOfLife->workBoard = gameOfLife->board;
+        gameOfLife->board = front;
+        TilesActivateAll( &gameOfLife->tiles );
+        gameOfLife->generation += pass;
+        generations -= pass;
+        StatsRecount( &gameOfLife->stats, &gameOfLife->tiles, &gameOfLife->workBoard, &gameOfLife->board,
+                      gameOfLife->generation );
+        if ( CyclesRehash( &gameOfLife->cycles, &gameOfLife->tiles, &gameOfLife->board, true, gameOfLife->generation ) ) {
+            CycleFound( gameOfLife );
+        }
+
+        if ( gameOfLife->checkpointEvery && gameOfLife->generation % gameOfLife->checkpointEvery == 0 ) {
+            CheckpointSimulation( gameOfLife );
+        }
+    }
+}
+
+void CheckpointSimulation( struct gameOfLife_t * gameOfLife ) {
+    struct snapshotWriter_t * checkpoint = &gameOfLife->checkpoint;
+
+    if ( checkpoint->path == NULL ) {
+        return;
+    }
+
+    /* the write in flight may be of this generation */
+    SnapshotWriterWait( checkpoint );
+    if ( checkpoint->saved && checkpoint->savedGeneration == gameOfLife->generation ) {
+        return;
+    }
+
+    SnapshotWriterStart( checkpoint, &gameOfLife->board, &gameOfLife->rule, gameOfLife->generation );
+}
+
+void FinishCheckpoint( struct gameOfLife_t * gameOfLife ) {
+    struct snapshotWriter_t * checkpoint = &gameOfLife->checkpoint;
+
+    CheckpointSimulation( gameOfLife );
+    SnapshotWriterWait( checkpoint );
+
+    if ( checkpoint->path != NULL && !( checkpoint->saved && checkpoint->savedGeneration == gameOfLife->generation ) ) {
+        Abort( "Cannot write the final checkpoint: {}", checkpoint->path );
+    }
+}
+
+const struct lifeStats_t * SimulationStats( const struct gameOfLife_t * gameOfLife ) {
+    return ( gameOfLife->stats.tiles != NULL ) ? &gameOfLife->stats.last : NULL;
+}
+
+void InvalidateSimulation( struct gameOfLife_t * gameOfLife ) {
+    /* a write finishing later would mark the edited generation as saved */
+    SnapshotWriterWait( &gameOfLife->checkpoint );
+    gameOfLife->checkpoint.saved = false;
+    TilesActivateAll( &gameOfLife->tiles );
+    StatsRecount( &gameOfLife->stats, &gameOfLife->tiles, NULL, &gameOfLife->board, gameOfLife->generation );
+    CyclesRehash( &gameOfLife->cycles, &gameOfLife->tiles, &gameOfLife->board, false, gameOfLife->generation );
+    gameOfLife->halted = false;
+}
+
+void DestroySimulation( struct gameOfLife_t * gameOfLife ) {
+    SnapshotWriterFree( &gameOfLife->checkpoint );
+    ThreadPoolDestroy( gameOfLife->threadPool );
+    gameOfLife->threadPool = NULL;
+    BoardFree( &gameOfLife->board );
+    BoardFree( &gameOfLife->workBoard );
+    TilesFree( &gameOfLife->tiles );
+    TemporalFree( &gameOfLife->temporal );
+    StatsFree( &gameOfLife->stats );
+    CyclesFree( &gameOfLife->cycles );
+}
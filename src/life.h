@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIFE_H
+#define LIFE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "cycles.h"
+#include "kernel.h"
+#include "options.h"
+#include "snapshot.h"
+#include "stats.h"
+#include "temporal.h"
+#include "threadpool.h"
+#include "tiles.h"
+
+struct gameOfLife_t {
+    bool     simulationPaused;
+    bool     unlimitedSpeed; /* step until the frame budget is spent */
+    double   generationsPerSecond; /* the pace of the window when the speed is limited */
+    uint64_t generation;
+    enum boundary_t boundary;
+    struct rule_t rule;
+    const struct lifeKernel_t * kernel;
+    struct board_t board; /* the board to display, the current generation */
+    struct board_t workBoard; /* the next generation is stepped into it, then the two swap */
+    struct tileSet_t tiles; /* the parts of the board that may change next */
+    struct threadPool_t * threadPool; /* every worker steps a share of the active tiles */
+    struct temporalBlocking_t temporal; /* depth 1 when off */
+    unsigned temporalGenerations; /* of the pass being run */
+    struct snapshotWriter_t checkpoint; /* no path when checkpoints are off */
+    uint64_t checkpointEvery; /* generations between checkpoints, 0 = only on exit */
+    struct statsCollector_t stats; /* no tiles when the statistics are off */
+    struct cycleDetector_t cycles; /* no tile hashes when the detection is off */
+    enum cycleMode_t cycleMode;
+    bool     halted; /* the board repeats and the run asked to stop on it */
+    bool     quiet;  /* found cycles are not printed, for the many runs of a soup search */
+};
+
+extern const unsigned MAX_THREADS;
+
+void InitializeSimulation( struct gameOfLife_t *, const struct options_t * );
+void StepSimulation( struct gameOfLife_t * );
+
+/* Advances the given number of generations, several at a time with temporal
+   blocking when it is on, or until the simulation halts on a cycle. */
+void AdvanceSimulation( struct gameOfLife_t *, uint64_t );
+
+/* restarts from generation 0 with a random soup of the given percentage
+   of live cells, drawn by all the workers and the same for a seed whatever
+   their number */
+void RandomizeSimulation( struct gameOfLife_t *, uint64_t, unsigned );
+
+/* the statistics of the current generation, NULL when they are off */
+const struct lifeStats_t * SimulationStats( const struct gameOfLife_t * );
+
+/* starts writing the board to the checkpoint file in the background, unless
+   there is none or this generation was already written */
+void CheckpointSimulation( struct gameOfLife_t * );
+
+/* checkpoints the current generation and waits for it, aborting when it
+   could not be written */
+void FinishCheckpoint( struct gameOfLife_t * );
+
+/* to be called after the board was edited, so all of it is stepped again */
+void InvalidateSimulation( struct gameOfLife_t * );
+void DestroySimulation( struct gameOfLife_t * );
+
+#endif
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+
+#include "lod.h"
+#include "util.h"
+
+#define BASE_SIDE ( 1u << LOD_BASE_LEVEL )
+
+void LodCreate( struct lodPyramid_t * lod, const struct board_t * board ) {
+    lod->levels = 0;
+
+    for ( unsigned level = LOD_BASE_LEVEL; lod->levels < LOD_MAX_LEVELS; level++ ) {
+        unsigned index = lod->levels++;
+
+        lod->columns[index] = (uint32_t) ( ( (uint64_t) board->width + ( 1u << level ) - 1 ) >> level );
+        lod->rows[index] = (uint32_t) ( ( (uint64_t) board->height + ( 1u << level ) - 1 ) >> level );
+        lod->density[index] = calloc( (size_t) lod->columns[index] * lod->rows[index], 1 );
+        if ( lod->density[index] == NULL ) {
+            Abort( "Cannot allocate the level of detail pyramid" );
+        }
+
+        if ( lod->columns[index] == 1 && lod->rows[index] == 1 ) {
+            break;
+        }
+    }
+}
+
+void LodFree( struct lodPyramid_t * lod ) {
+    for ( unsigned index = 0; index < lod->levels; index++ ) {
+        free( lod->density[index] );
+        lod->density[index] = NULL;
+    }
+
+    lod->levels = 0;
+}
+
+/* the up to 8 cells of a row from col on, as the low bits of a byte */
+static inline unsigned RowByte( const struct board_t * board, uint32_t row, uint32_t col ) {
+    uint32_t count = ( board->width - col < 8 ) ? board->width - col : 8;
+    unsigned cells = 0;
+
+    if ( board->layout == LAYOUT_BYTES ) {
+        const uint8_t * bytes = BoardRowBytes( board, row ) + col + 1;
+
+        for ( uint32_t i = 0; i < count; i++ ) {
+            cells |= (unsigned) bytes[i] << i;
+        }
+        return cells;
+    }
+
+    /* the spare word at the end of the row keeps the second word readable */
+    const uint64_t * words = BoardRow( board, row );
+    uint32_t position = col + 1, shift = position & 63;
+    uint64_t bits = words[position >> 6] >> shift;
+
+    if ( shift > 56 ) {
+        bits |= words[( position >> 6 ) + 1] << ( 64 - shift );
+    }
+
+    return (unsigned) bits & ( ( 1u << count ) - 1 );
+}
+
+static void UpdateBase( struct lodPyramid_t * lod, const struct board_t * board,
+                        uint32_t rowBegin, uint32_t rowEnd, uint32_t colBegin, uint32_t colEnd ) {
+    for ( uint32_t blockRow = rowBegin; blockRow < rowEnd; blockRow++ ) {
+        uint32_t lastRow = ( ( blockRow + 1 ) * BASE_SIDE < board->height ) ? ( blockRow + 1 ) * BASE_SIDE : board->height;
+
+        for ( uint32_t blockCol = colBegin; blockCol < colEnd; blockCol++ ) {
+            unsigned population = 0;
+
+            for ( uint32_t row = blockRow * BASE_SIDE; row < lastRow; row++ ) {
+                population += __builtin_popcount( RowByte( board, row, blockCol * BASE_SIDE ) );
+            }
+
+            lod->density[0][(size_t) blockRow * lod->columns[0] + blockCol] =
+                (uint8_t) ( ( population * 255 + BASE_SIDE * BASE_SIDE / 2 ) / ( BASE_SIDE * BASE_SIDE ) );
+        }
+    }
+}
+
+/* a block is the mean of the four below it, those past the edge being empty */
+static void UpdateLevel( struct lodPyramid_t * lod, unsigned index,
+                         uint32_t rowBegin, uint32_t rowEnd, uint32_t colBegin, uint32_t colEnd ) {
+    for ( uint32_t row = rowBegin; row < rowEnd; row++ ) {
+        for ( uint32_t col = colBegin; col < colEnd; col++ ) {
+            unsigned sum = 0;
+
+            for ( unsigned child = 0; child < 4; child++ ) {
+                uint32_t childRow = 2 * row + child / 2, childCol = 2 * col + child % 2;
+
+                if ( childRow < lod->rows[index - 1] && childCol < lod->columns[index - 1] ) {
+                    sum += lod->density[index - 1][(size_t) childRow * lod->columns[index - 1] + childCol];
+                }
+            }
+
+            lod->density[index][(size_t) row * lod->columns[index] + col] = (uint8_t) ( ( sum + 2 ) / 4 );
+        }
+    }
+}
+
+void LodUpdate( struct lodPyramid_t * lod, const struct board_t * board, struct tileSet_t * tiles ) {
+    uint32_t cellsPerWord = ( board->layout == LAYOUT_BYTES ) ? 8 : 64;
+
+    for ( uint32_t tile = 0; tile < tiles->columns * tiles->rows; tile++ ) {
+        uint32_t rowBegin, rowEnd, wordBegin, wordEnd, colBegin, colEnd;
+
+        if ( !tiles->dirty[tile] ) {
+            continue;
+        }
+        tiles->dirty[tile] = 0;
+
+        /* the tile holds positions, which are the cells shifted by the ghost cell */
+        TilesGetBounds( tiles, board, tile, &rowBegin, &rowEnd, &wordBegin, &wordEnd );
+        colBegin = ( wordBegin > 0 ) ? wordBegin * cellsPerWord - 1 : 0;
+        colEnd = ( wordEnd * cellsPerWord - 1 < board->width ) ? wordEnd * cellsPerWord - 1 : board->width;
+        if ( colBegin >= colEnd ) {
+            continue;
+        }
+
+        /* the blocks touching the tile at every level */
+        rowBegin /= BASE_SIDE;
+        rowEnd = ( rowEnd + BASE_SIDE - 1 ) / BASE_SIDE;
+        colBegin /= BASE_SIDE;
+        colEnd = ( colEnd + BASE_SIDE - 1 ) / BASE_SIDE;
+        UpdateBase( lod, board, rowBegin, rowEnd, colBegin, colEnd );
+
+        for ( unsigned index = 1; index < lod->levels; index++ ) {
+            rowBegin /= 2;
+            rowEnd = ( rowEnd + 1 ) / 2;
+            colBegin /= 2;
+            colEnd = ( colEnd + 1 ) / 2;
+            UpdateLevel( lod, index, rowBegin, rowEnd, colBegin, colEnd );
+        }
+    }
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOD_H
+#define LOD_H
+
+/* A density pyramid for drawing the board zoomed out: level L holds the
+   share of live cells of every block of 2^L x 2^L cells, so a pixel showing
+   such a block costs one lookup however many cells it covers. Only the
+   levels from LOD_BASE_LEVEL up are stored, finer ones are cheap to count
+   from the board, and only the blocks under tiles that changed are
+   recomputed. */
+
+#include <stdint.h>
+
+#include "board.h"
+#include "tiles.h"
+
+#define LOD_BASE_LEVEL 3  /* blocks of 8 x 8 cells */
+#define LOD_MAX_LEVELS 18 /* up to a single block for the largest board */
+
+struct lodPyramid_t {
+    unsigned  levels;                   /* stored, LOD_BASE_LEVEL first */
+    uint32_t  columns[LOD_MAX_LEVELS];  /* blocks across a level */
+    uint32_t  rows[LOD_MAX_LEVELS];
+    uint8_t * density[LOD_MAX_LEVELS];  /* 0 for an empty block to 255 for a full one */
+};
+
+void LodCreate( struct lodPyramid_t *, const struct board_t * );
+void LodFree( struct lodPyramid_t * );
+
+/* Recomputes the blocks under the dirty tiles and marks them clean. */
+void LodUpdate( struct lodPyramid_t *, const struct board_t *, struct tileSet_t * );
+
+/* the density of a block of a level from LOD_BASE_LEVEL up, 0 off the board */
+static inline uint8_t LodDensity( const struct lodPyramid_t * lod, unsigned level, int64_t row, int64_t col ) {
+    unsigned index = level - LOD_BASE_LEVEL;
+
+    if ( index >= lod->levels || row < 0 || col < 0 || row >= lod->rows[index] || col >= lod->columns[index] ) {
+        return 0;
+    }
+
+    return lod->density[index][row * lod->columns[index] + col];
+}
+
+#endif
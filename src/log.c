@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "log.h"
+#include "util.h"
+
+#define LOG_RECORDS  128      /* a ring, per thread */
+#define LOG_TEXT     240      /* bytes of a message, longer ones are cut */
+#define LOG_PERIOD   20000000 /* nanoseconds between the writes of the background thread */
+#define LOG_BUFFER   65536    /* bytes of lines gathered for a write */
+
+struct logRecord_t {
+    uint64_t        time;
+    enum logLevel_t level;
+    char            text[LOG_TEXT];
+};
+
+/* Written by its thread only, read by whoever holds the flush lock: the
+   head is published after the record it covers, the tail after the record
+   was copied out, so neither side locks. */
+struct logRing_t {
+    struct logRecord_t records[LOG_RECORDS];
+    uint64_t           head __attribute__(( aligned( 64 ) )); /* records written */
+    uint64_t           tail __attribute__(( aligned( 64 ) )); /* records flushed */
+    unsigned           thread;
+    struct logRing_t * next;
+};
+
+static const char * gLevelNames[] = { "error", "warning", "info", "debug" };
+
+enum logLevel_t gLogLevel = LOG_INFO;
+
+static struct logRing_t * gRings;   /* every thread that logged, newest first */
+static unsigned           gThreads; /* rings handed out */
+static __thread struct logRing_t * tRing;
+
+static pthread_mutex_t gFlushLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t       gWriter;
+static bool            gRunning;
+static bool            gStopping;
+static uint64_t        gStartTime;
+static char            gBuffer[LOG_BUFFER];
+
+/* the ring of the calling thread, made on its first message */
+static struct logRing_t * GetRing( void ) {
+    struct logRing_t * ring = tRing;
+
+    if ( ring != NULL ) {
+        return ring;
+    }
+
+    ring = calloc( 1, sizeof ( *ring ) );
+    if ( ring == NULL ) {
+        return NULL;
+    }
+
+    ring->thread = __atomic_fetch_add( &gThreads, 1, __ATOMIC_RELAXED );
+    ring->next = __atomic_load_n( &gRings, __ATOMIC_RELAXED );
+    while ( !__atomic_compare_exchange_n( &gRings, &ring->next, ring, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED ) ) {
+    }
+
+    tRing = ring;
+    return ring;
+}
+
+/* a record as a line at the end of the buffer, which is written out first when full */
+static size_t AppendLine( size_t size, const struct logRecord_t * record, unsigned thread ) {
+    uint64_t elapsed = ( gStartTime != 0 && record->time > gStartTime ) ? record->time - gStartTime : 0;
+    char line[LOG_TEXT + 64];
+    int length = snprintf( line, sizeof ( line ), "%llu.%06llu %s t%u %s\n",
+                           (unsigned long long) ( elapsed / 1000000000u ),
+                           (unsigned long long) ( elapsed % 1000000000u / 1000u ),
+                           gLevelNames[record->level], thread, record->text );
+
+    length = ( length < (int) sizeof ( line ) ) ? length : (int) sizeof ( line ) - 1;
+    if ( size + length > sizeof ( gBuffer ) ) {
+        fwrite( gBuffer, 1, size, stderr );
+        size = 0;
+    }
+
+    memcpy( gBuffer + size, line, length );
+    return size + length;
+}
+
+/* The rings are merged by time, the oldest record of any of them going
+   first. Only the records published when it starts are taken. */
+void LogFlush( void ) {
+    struct logRing_t * rings;
+    size_t size = 0;
+
+    pthread_mutex_lock( &gFlushLock );
+    rings = __atomic_load_n( &gRings, __ATOMIC_ACQUIRE );
+
+    for ( ;; ) {
+        struct logRing_t * oldest = NULL;
+
+        for ( struct logRing_t * ring = rings; ring != NULL; ring = ring->next ) {
+            if ( ring->tail != __atomic_load_n( &ring->head, __ATOMIC_ACQUIRE ) &&
+                 ( oldest == NULL || ring->records[ring->tail % LOG_RECORDS].time <
+                                     oldest->records[oldest->tail % LOG_RECORDS].time ) ) {
+                oldest = ring;
+            }
+        }
+
+        if ( oldest == NULL ) {
+            break;
+        }
+
+        size = AppendLine( size, &oldest->records[oldest->tail % LOG_RECORDS], oldest->thread );
+        __atomic_store_n( &oldest->tail, oldest->tail + 1, __ATOMIC_RELEASE );
+    }
+
+    fwrite( gBuffer, 1, size, stderr );
+    pthread_mutex_unlock( &gFlushLock );
+}
+
+static void * WriteLoop( void * unused ) {
+    struct timespec pause = { .tv_sec = 0, .tv_nsec = LOG_PERIOD };
+
+    (void) unused;
+    while ( !__atomic_load_n( &gStopping, __ATOMIC_ACQUIRE ) ) {
+        LogFlush();
+        nanosleep( &pause, NULL );
+    }
+
+    return NULL;
+}
+
+void LogStart( enum logLevel_t level ) {
+    gLogLevel = level;
+    gStartTime = NanoTime();
+
+    if ( pthread_create( &gWriter, NULL, WriteLoop, NULL ) != 0 ) {
+        return; /* the messages are written at once instead */
+    }
+
+    __atomic_store_n( &gRunning, true, __ATOMIC_RELEASE );
+    atexit( LogStop );
+}
+
+void LogStop( void ) {
+    if ( !__atomic_exchange_n( &gRunning, false, __ATOMIC_ACQ_REL ) ) {
+        return;
+    }
+
+    __atomic_store_n( &gStopping, true, __ATOMIC_RELEASE );
+    pthread_join( gWriter, NULL );
+    LogFlush();
+}
+
+bool ParseLogLevel( const char * text, enum logLevel_t * level ) {
+    for ( unsigned i = 0; i < ARRAY_SIZE( gLevelNames, const char * ); i++ ) {
+        if ( strcmp( text, gLevelNames[i] ) == 0 ) {
+            *level = (enum logLevel_t) i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void LogWrite( enum logLevel_t level, const char * format, ... ) {
+    struct logRing_t * ring = __atomic_load_n( &gRunning, __ATOMIC_ACQUIRE ) ? GetRing() : NULL;
+    struct logRecord_t * record, direct;
+    va_list arguments;
+
+    if ( ring != NULL ) {
+        /* a full ring is written out by its own thread */
+        if ( ring->head - __atomic_load_n( &ring->tail, __ATOMIC_ACQUIRE ) == LOG_RECORDS ) {
+            LogFlush();
+        }
+        record = &ring->records[ring->head % LOG_RECORDS];
+    } else {
+        record = &direct;
+    }
+
+    record->time = NanoTime();
+    record->level = level;
+    va_start( arguments, format );
+    vsnprintf( record->text, sizeof ( record->text ), format, arguments );
+    va_end( arguments );
+
+    if ( ring != NULL ) {
+        __atomic_store_n( &ring->head, ring->head + 1, __ATOMIC_RELEASE );
+
+        /* the background thread may have stopped since, its last flush missing the record */
+        if ( !__atomic_load_n( &gRunning, __ATOMIC_ACQUIRE ) ) {
+            LogFlush();
+        }
+        return;
+    }
+
+    pthread_mutex_lock( &gFlushLock );
+    fwrite( gBuffer, 1, AppendLine( 0, record, 0 ), stderr );
+    pthread_mutex_unlock( &gFlushLock );
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+/* Status and error messages, as lines of the seconds since the start, the
+   level, the thread and the text on stderr. Every thread formats its
+   messages into a ring of its own without locking, and a background thread
+   writes the rings out in time order a few times a second, in large writes.
+   A message below the level chosen costs a comparison and its arguments are
+   never evaluated; levels above LOG_MAX_LEVEL are compiled out altogether.
+   Before LogStart() and after LogStop() messages are written at once. */
+
+#include <stdbool.h>
+
+enum logLevel_t {
+    LOG_ERROR,
+    LOG_WARNING,
+    LOG_INFO,
+    LOG_DEBUG
+};
+
+#ifndef LOG_MAX_LEVEL
+#define LOG_MAX_LEVEL LOG_DEBUG
+#endif
+
+#define LOG( level, ... ) do {                                          \
+        if ( (level) <= LOG_MAX_LEVEL && (level) <= gLogLevel ) {       \
+            LogWrite( (level), __VA_ARGS__ );                           \
+        }                                                               \
+    } while ( 0 )
+
+extern enum logLevel_t gLogLevel;
+
+/* sets the level and starts the background writer, which stops at exit */
+void LogStart( enum logLevel_t );
+
+/* writes out every message left and stops the background writer */
+void LogStop( void );
+
+/* writes out the messages logged so far */
+void LogFlush( void );
+
+/* turns a level name such as "info" into the level, false when unknown */
+bool ParseLogLevel( const char *, enum logLevel_t * );
+
+void LogWrite( enum logLevel_t, const char *, ... ) __attribute__(( format( printf, 2, 3 ) ));
+
+#endif
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lutkernel.h"
+#include "stats.h"
+#include "util.h"
+
+#define LUT_ENTRIES ( 1 << 16 )
+
+/* The 4x4 block is four nibbles, the row above the pair first, bit i of a
+   nibble being the cell i - 1 columns from the left cell of the pair. An
+   entry holds the pair of the top row in bits 0-1 and of the bottom row in
+   bits 2-3. */
+struct lutTable_t {
+    uint8_t next[2][9];                 /* the rule it was built for */
+    uint8_t blocks[LUT_ENTRIES];
+    struct lutTable_t * older;
+};
+
+/* Tables are never freed: every worker may be reading one, and a run only
+   ever uses a rule or two. */
+static struct lutTable_t * gTables;
+static pthread_mutex_t gTablesLock = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned BlockCell( unsigned block, int row, int col ) {
+    if ( row < 0 || row > 3 || col < 0 || col > 3 ) {
+        return 0;
+    }
+
+    return ( block >> ( row * 4 + col ) ) & 1;
+}
+
+static void BuildTable( const struct rule_t * rule, struct lutTable_t * table ) {
+    memcpy( table->next, rule->next, sizeof ( table->next ) );
+
+    for ( unsigned block = 0; block < LUT_ENTRIES; block++ ) {
+        uint8_t result = 0;
+
+        for ( int cell = 0; cell < 4; cell++ ) {
+            int row = 1 + cell / 2, col = 1 + cell % 2;
+            unsigned neighbours = 0;
+
+            for ( int dy = -1; dy <= 1; dy++ ) {
+                for ( int dx = -1; dx <= 1; dx++ ) {
+                    if ( dy != 0 || dx != 0 ) {
+                        neighbours += BlockCell( block, row + dy, col + dx );
+                    }
+                }
+            }
+
+            result |= rule->next[BlockCell( block, row, col )][neighbours] << cell;
+        }
+
+        table->blocks[block] = result;
+    }
+}
+
+static const struct lutTable_t * FindTable( const struct rule_t * rule ) {
+    struct lutTable_t * table = __atomic_load_n( &gTables, __ATOMIC_ACQUIRE );
+
+    for ( ; table != NULL; table = table->older ) {
+        if ( memcmp( table->next, rule->next, sizeof ( table->next ) ) == 0 ) {
+            return table;
+        }
+    }
+
+    /* the first tile of a new rule builds it while the other workers wait */
+    pthread_mutex_lock( &gTablesLock );
+    for ( table = gTables; table != NULL; table = table->older ) {
+        if ( memcmp( table->next, rule->next, sizeof ( table->next ) ) == 0 ) {
+            break;
+        }
+    }
+
+    if ( table == NULL ) {
+        table = malloc( sizeof ( *table ) );
+        if ( table == NULL ) {
+            Abort( "Cannot allocate the lookup table" );
+        }
+
+        BuildTable( rule, table );
+        table->older = gTables;
+        __atomic_store_n( &gTables, table, __ATOMIC_RELEASE );
+    }
+    pthread_mutex_unlock( &gTablesLock );
+
+    return table;
+}
+
+/* The row from the cell west of the word, bit 0 being the cell before bit 0
+   of the word, and the two cells after its end in bits 64-65. */
+static inline void GetWindow( const uint64_t * row, uint32_t word, uint64_t * low, uint64_t * high ) {
+    uint64_t west = ( word > 0 ) ? row[word - 1] : 0;
+
+    *low = ( row[word] << 1 ) | ( west >> 63 );
+    *high = ( row[word] >> 63 ) | ( row[word + 1] << 1 );
+}
+
+/* Two rows of a word: the nibbles of the four rows are paired into bytes,
+   so each phase of the 2-cell step looks up eight blocks from two bytes. */
+static inline void NextPair( const uint8_t * blocks, const uint64_t * rows[4], uint32_t word,
+                             uint64_t * top, uint64_t * bottom ) {
+    uint64_t low[4], high[4];
+
+    for ( int i = 0; i < 4; i++ ) {
+        GetWindow( rows[i], word, &low[i], &high[i] );
+    }
+
+    *top = 0;
+    *bottom = 0;
+    for ( unsigned phase = 0; phase < 8; phase += 2 ) {
+        uint64_t shifted[4];
+        uint64_t northPairs, southPairs;
+
+        for ( int i = 0; i < 4; i++ ) {
+            shifted[i] = phase ? ( low[i] >> phase ) | ( high[i] << ( 64 - phase ) ) : low[i];
+        }
+
+        northPairs = ( shifted[0] & UINT64_C( 0x0f0f0f0f0f0f0f0f ) ) | ( ( shifted[1] & UINT64_C( 0x0f0f0f0f0f0f0f0f ) ) << 4 );
+        southPairs = ( shifted[2] & UINT64_C( 0x0f0f0f0f0f0f0f0f ) ) | ( ( shifted[3] & UINT64_C( 0x0f0f0f0f0f0f0f0f ) ) << 4 );
+
+        for ( unsigned byte = 0; byte < 8; byte++ ) {
+            unsigned index = ( ( northPairs >> ( byte * 8 ) ) & 0xff ) | ( ( ( southPairs >> ( byte * 8 ) ) & 0xff ) << 8 );
+            uint64_t result = blocks[index];
+            unsigned bit = byte * 8 + phase;
+
+            *top |= ( result & 3 ) << bit;
+            *bottom |= ( result >> 2 ) << bit;
+        }
+    }
+}
+
+/* the cells of a word, leaving out the ghost cells and the padding */
+static inline uint64_t CellMask( const struct board_t * board, uint32_t word ) {
+    uint32_t lastCellWord = board->width >> 6; /* the last cell is bit width */
+    uint64_t mask = ( word < lastCellWord ) ? ~UINT64_C( 0 ) :
+                    ( word == lastCellWord ) ? ~UINT64_C( 0 ) >> ( 63 - ( board->width & 63 ) ) : 0;
+
+    return ( word == 0 ) ? mask & ~UINT64_C( 1 ) : mask;
+}
+
+int LutStepTile( const struct rule_t * rule, const struct board_t * src, struct board_t * dst,
+                 uint32_t rowBegin, uint32_t rowEnd, uint32_t wordBegin, uint32_t wordEnd, struct tileStats_t * stats ) {
+    const uint8_t * blocks = FindTable( rule )->blocks;
+    uint64_t changed = 0;
+
+    for ( uint32_t row = rowBegin; row < rowEnd; row += 2 ) {
+        /* An odd row at the end is stepped as the top of a pair whose bottom
+           is dropped; the top only depends on the three rows around it, so
+           any row will do below them, and past the last row there is none. */
+        int single = ( row + 1 == rowEnd );
+        const uint64_t * rows[4] = {
+            BoardRow( src, (int64_t) row - 1 ), BoardRow( src, row ), BoardRow( src, (int64_t) row + 1 ),
+            BoardRow( src, single ? (int64_t) row + 1 : (int64_t) row + 2 )
+        };
+        uint64_t * nextTop = BoardRow( dst, row );
+        uint64_t * nextBottom = BoardRow( dst, single ? row : (int64_t) row + 1 );
+
+        for ( uint32_t word = wordBegin; word < wordEnd; word++ ) {
+            uint64_t cells = CellMask( src, word );
+            uint64_t top, bottom;
+
+            NextPair( blocks, rows, word, &top, &bottom );
+
+            if ( !single ) {
+                nextBottom[word] = bottom & cells;
+                changed |= ( nextBottom[word] ^ rows[2][word] ) & cells;
+                if ( stats != NULL ) {
+                    StatsAddChange( stats, rows[2][word] & cells, nextBottom[word] );
+                }
+            }
+
+            nextTop[word] = top & cells;
+            changed |= ( nextTop[word] ^ rows[1][word] ) & cells;
+            if ( stats != NULL ) {
+                StatsAddChange( stats, rows[1][word] & cells, nextTop[word] );
+            }
+        }
+
+        if ( stats != NULL ) {
+            StatsAddBounds( stats, dst, row, nextTop, wordBegin, wordEnd );
+            if ( !single ) {
+                StatsAddBounds( stats, dst, row + 1, nextBottom, wordBegin, wordEnd );
+            }
+        }
+    }
+
+    return changed != 0;
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LUTKERNEL_H
+#define LUTKERNEL_H
+
+/* A stepper for the bit-packed layout that needs no neighbour counting:
+   the next state of every 2x2 block of cells is looked up from the 4x4
+   block around it, 16 bits indexing a table of 65536 entries built once
+   per rule. Plain C, so it runs anywhere. */
+
+#include <stdint.h>
+
+#include "board.h"
+
+/* same contract as BoardStepTile() */
+int LutStepTile( const struct rule_t *, const struct board_t *, struct board_t *,
+                 uint32_t, uint32_t, uint32_t, uint32_t, struct tileStats_t * );
+
+#endif
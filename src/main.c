@@ -16,295 +16,62 @@
  */
 
 /* This is a C + SDL2 implementation of Conway's Game Of Life */
-/* Keybindings:
-   - minus             -> slow down simulation
-   - plus              -> fasten simulation
-   - p                 -> pause / resume
-   - left mouse click  -> change cells color
-   - right mouse click -> change background color
-   - escape / q        -> quit the simulation
-   - F11               -> fullscreen
- */
+/* Run with --help for the command line options; --headless runs the
+   simulation without a window, which is the only mode available when built
+   with NO_GRAPHICS (make headless). */
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <stdarg.h>
-#include <time.h>
-
-#include <SDL2/SDL.h>
-
-#define ARRAY_SIZE( name, type ) ( sizeof( name ) / sizeof ( type ) )
-
-struct SDL_Color gameColors = {
-    .r = 255,
-    .g = 127,
-    .b = 0,
-    .a = 255
-};
-
-struct SDL_Color backgroundColor = {
-    .r = 0,
-    .g = 0,
-    .b = 0,
-    .a = 255
-};
-
-const uint8_t  DEFAULT_DELTA_TIME = 60;
-const uint16_t BOARD_SIDE         = 200;
-const uint8_t  PIXEL_SIZE         = 5;
-uint8_t        gFullscreen        = 0;
-
-struct gameOfLife_t {
-    uint8_t  deltaTime;
-    SDL_bool simulationPaused;
-    uint8_t  board[BOARD_SIDE][BOARD_SIDE]; /* the board to display */
-    uint8_t  workBoard[BOARD_SIDE][BOARD_SIDE]; /* the working board */
-};
-
-SDL_Window *   gWindow   = NULL;
-SDL_Renderer * gRenderer = NULL;
 
-void Abort( const char *, ... );
-void InitializeGraphics( void );
-void InitializeSimulation( struct gameOfLife_t * );
-void SimulationLoop( struct gameOfLife_t * );
-void CleanUp( void );
-
-int GetRowByIndex( int );
-int GetColumnByIndex( int );
-
-void UpdateBoard( struct gameOfLife_t * );
-void EvaluateKey( SDL_Event *, struct gameOfLife_t * );
-void ApplyLifeRule( struct gameOfLife_t *, int, int );
-
-int main( void ) {
-    struct gameOfLife_t gameOfLife = {
-        .deltaTime = DEFAULT_DELTA_TIME,
-        .simulationPaused = SDL_FALSE
+#include "bench.h"
+#include "headless.h"
+#include "life.h"
+#include "log.h"
+#include "options.h"
+#include "soup.h"
+#include "util.h"
+
+#ifndef NO_GRAPHICS
+#include "graphics.h"
+#endif
+
+int main( int argc, char ** argv ) {
+    static struct gameOfLife_t gameOfLife = {
+        .simulationPaused = false,
+        .unlimitedSpeed = false
     };
+    struct options_t options;
 
-    InitializeGraphics();
-    atexit( CleanUp );
-    InitializeSimulation( &gameOfLife );
-    SimulationLoop( &gameOfLife );
-}
-
-void Abort( const char * errorMessage, ... ) {
-    va_list stackArguments;
-
-    for ( int c = 0; errorMessage[c] != '\0'; c++ ) {
-        if ( errorMessage[c] == '{' && errorMessage[c+1] == '}' ) {
-            fprintf( stderr, "%s", va_arg( stackArguments, const char * ) );
-            c++;
-        } else {
-            fputc( errorMessage[c], stderr );
-        }
-    }
-
-    fputc( '\n', stderr );
-    exit( 1 );
-}
-
-void InitializeGraphics( void ) {
-    if ( SDL_Init( SDL_INIT_VIDEO ) ) {
-        Abort( "Cannot initialize SDL2: {}", SDL_GetError() );
-    }
-
-    gWindow = SDL_CreateWindow( "Game of Life",
-                                SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-                                PIXEL_SIZE * BOARD_SIDE, PIXEL_SIZE * BOARD_SIDE,
-                                SDL_WINDOW_SHOWN );
+    ParseOptions( argc, argv, &options );
+    LogStart( options.logLevel );
 
-    if ( gWindow == NULL ) {
-        Abort( "[-] Cannot create window: {}", SDL_GetError() );
+    if ( options.bench ) {
+        RunBenchmark( &options );
+        return 0;
     }
 
-    gRenderer = SDL_CreateRenderer( gWindow, -1, SDL_RENDERER_PRESENTVSYNC | SDL_RENDERER_ACCELERATED );
-
-    if ( gRenderer == NULL ) {
-        Abort( "[-] Cannot create renderer: {}", SDL_GetError() );
+    if ( options.soups > 0 ) {
+        RunSoupSearch( &options );
+        return 0;
     }
 
-    SDL_SetRenderDrawColor( gRenderer, gameColors.r, gameColors.g, gameColors.b, gameColors.a );
-    SDL_RenderClear( gRenderer );
-}
-
-void InitializeSimulation( struct gameOfLife_t * gameOfLife ) {
-    uint8_t randomNumber;
-
-    srand( time( 0 ) );
-    for ( uint16_t i = 0; i < BOARD_SIDE * BOARD_SIDE; i++ ) {
-        randomNumber = random() % 10;
-        if ( randomNumber == 0 ) {
-            gameOfLife->board[GetColumnByIndex( i )][GetRowByIndex( i )] = 1;
-        } else {
-            gameOfLife->board[GetColumnByIndex( i )][GetRowByIndex( i )] = 0;
-        }
-
-        if ( (i + 1) % BOARD_SIDE == 0 ) {
-            printf( "\n" );
-        }
+    if ( options.headless ) {
+        InitializeSimulation( &gameOfLife, &options );
+        RunHeadless( &gameOfLife, &options );
+        DestroySimulation( &gameOfLife );
+        return 0;
     }
-}
-
-void SimulationLoop( struct gameOfLife_t * gameOfLife ) {
-    SDL_Event event;
-    struct SDL_Color * colorPointer;
-
-    for ( ;; ) {
-        if ( !gameOfLife->simulationPaused ) {
-            UpdateBoard( gameOfLife );
-        }
-
-        while ( SDL_PollEvent( &event ) ) {
-            switch ( event.type ) {
-            case SDL_QUIT:
-                puts( "Arrivederci" );
-                exit( 0 );
-
-            case SDL_KEYDOWN:
-                EvaluateKey( &event, gameOfLife );
-                break;
 
-            case SDL_MOUSEBUTTONDOWN:
-                if ( event.button.button == SDL_BUTTON_LEFT ) {
-                    colorPointer = &gameColors;
-                } else {
-                    colorPointer = &backgroundColor;
-                }
-                
-                colorPointer->r = random() % 256;
-                colorPointer->g = random() % 256;
-                colorPointer->b = random() % 256;
-                UpdateBoard( gameOfLife );
-                break;
-            }
-        }
+#ifdef NO_GRAPHICS
+    Abort( "Built without graphics, run with --headless" );
+#else
+    gameOfLife.generationsPerSecond = DEFAULT_GENERATIONS_PER_SECOND;
 
-        SDL_Delay( 1000 / gameOfLife->deltaTime );
-    }
-}
-
-void CleanUp( void ) {
-    SDL_DestroyRenderer( gRenderer );
-    SDL_DestroyWindow( gWindow );
-    SDL_Quit();
-}
-
-int GetRowByIndex( int index ) {
-    int row = index / BOARD_SIDE;
-    return row;
-}
-
-int GetColumnByIndex( int index ) {
-    int column = index % BOARD_SIDE;
-    return column;
-}
-
-void UpdateBoard( struct gameOfLife_t * gameOfLife ) {
-    struct SDL_Rect pixel = {
-                             .w = PIXEL_SIZE,
-                             .h = PIXEL_SIZE,
-                             .x = 0,
-                             .y = 0
-    };
-
-    uint16_t lineX = 0;
-
-    /* Clear the screen */
-    SDL_SetRenderDrawColor( gRenderer, backgroundColor.r, backgroundColor.g, backgroundColor.b, backgroundColor.a );
-    SDL_RenderClear( gRenderer );
-
-    /* Draw the board */
-    SDL_SetRenderDrawColor( gRenderer, gameColors.r, gameColors.g, gameColors.b, gameColors.a );
-    while ( lineX < PIXEL_SIZE * BOARD_SIDE ) {
-        SDL_RenderDrawLine( gRenderer, 0, lineX, PIXEL_SIZE * BOARD_SIDE, lineX );
-        SDL_RenderDrawLine( gRenderer, lineX, 0, lineX, PIXEL_SIZE * BOARD_SIDE );
-        lineX += PIXEL_SIZE;
-    }
-
-    /* work on the new arena */
-    /* work on the board */
-    for ( int i = BOARD_SIDE; i < BOARD_SIDE * BOARD_SIDE; i++ ) {
-        ApplyLifeRule( gameOfLife, GetRowByIndex( i ), GetColumnByIndex( i ) );
-    }
-    
-    /* set the new board to the working board */
-    memcpy( gameOfLife->board, gameOfLife->workBoard, sizeof ( gameOfLife->workBoard ) );
-
-    /* draw the life cells */
-    for ( int i = 0; i < BOARD_SIDE * BOARD_SIDE; i++ ) {
-        if ( gameOfLife->board[GetRowByIndex( i )][GetColumnByIndex( i )] == 1 ) {
-            pixel.x = GetRowByIndex( i ) * PIXEL_SIZE;
-            pixel.y = GetColumnByIndex( i ) * PIXEL_SIZE;
-            SDL_RenderFillRect( gRenderer, &pixel );
-        }
-    }
-
-    /* show the changes to the screen */
-    SDL_RenderPresent( gRenderer );
-}
-
-void EvaluateKey( SDL_Event * event, struct gameOfLife_t * gameOfLife ) {
-    switch ( event->key.keysym.sym ) {
-    case SDLK_ESCAPE:
-    case SDLK_q:
-        puts( "Arrivederci" );
-        exit( 0 );
-
-    case SDLK_p:
-        gameOfLife->simulationPaused = ( gameOfLife->simulationPaused ) ? SDL_FALSE : SDL_TRUE;
-        printf( "Pause: %d\n", gameOfLife->simulationPaused );
-        break;
-
-    case SDLK_MINUS:
-        gameOfLife->deltaTime--;
-        break;
-
-    case SDLK_PLUS:
-        gameOfLife->deltaTime++;
-        break;
-
-    case SDLK_F11:
-        if ( gFullscreen ) {
-            SDL_SetWindowFullscreen( gWindow, SDL_WINDOW_SHOWN );
-            gFullscreen = 0;
-        } else {
-            SDL_SetWindowFullscreen( gWindow, SDL_WINDOW_SHOWN | SDL_WINDOW_FULLSCREEN_DESKTOP );
-            gFullscreen = 1;
-        }
-    }
-}
-
-void ApplyLifeRule( struct gameOfLife_t * gameOfLife, int row, int col ) {
-    /* A rewrite would be beneficial, this sucks on eyes! */
-    if ( row > 0 && row < BOARD_SIDE - 1 ) {
-        /* not the bottom or top row */
-        if ( col > 0 && col < BOARD_SIDE - 1 ) {
-            /* middle board */
-            int lifeForms = 0;
-            for ( int neighbourRow = row - 1; neighbourRow < row + 2; neighbourRow++ ) {
-                for ( int neighbourCol = col - 1; neighbourCol < col + 2; neighbourCol++ ) {
-                    if ( gameOfLife->board[neighbourRow][neighbourCol] ) {
-                        lifeForms++;
-                    }
-                }
-            }
-            lifeForms--;
+    InitializeSimulation( &gameOfLife, &options );
+    InitializeGraphics( gameOfLife.board.width, gameOfLife.board.height );
+    atexit( CleanUp );
+    SimulationLoop( &gameOfLife );
+#endif
 
-            /* rule 1 and 3 */
-            if ( lifeForms < 2 || lifeForms > 3 ) {
-                gameOfLife->workBoard[row][col] = 0;
-            } else {
-                /* rule 2 and 4 */
-                gameOfLife->workBoard[row][col] = 1;
-            }
-        } else {
-            /* left or right column */
-            /* to implement */
-        }
-    } else {
-        /* top or bottom row */
-        /* to implement */
-    }
+    return 0;
 }
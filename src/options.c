@@ -0,0 +1,454 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "options.h"
+#include "temporal.h"
+#include "util.h"
+
+const uint64_t DEFAULT_HEADLESS_GENERATIONS = 1000;
+const uint64_t DEFAULT_MEMORY_LIMIT_MB = 1024;
+const char *   DEFAULT_KERNEL = "bits";
+const unsigned DEFAULT_DENSITY = 10;
+const unsigned DEFAULT_TRIALS = 5;
+const unsigned DEFAULT_WARMUP_TRIALS = 1;
+const uint32_t DEFAULT_SOUP_SIDE = 16;
+const unsigned DEFAULT_SOUP_DENSITY = 50;
+const uint64_t DEFAULT_SOUP_GENERATIONS = 20000;
+
+static void PrintUsage( const char * program ) {
+    printf( "Usage: %s [options]\n"
+            "  -H, --headless           run without a window and print statistics\n"
+            "  -g, --generations N      generations to run in headless mode (default %llu)\n"
+            "  -r, --report N           print the population every N generations\n"
+            "  -s, --seed N             seed for the random initial soup\n"
+            "  -f, --pattern FILE       start from an RLE (.rle) or plaintext (.cells) pattern\n"
+            "  -o, --output FILE        write the final board as RLE (headless board engine)\n"
+            "  -l, --restore FILE       continue the run saved in a snapshot\n"
+            "  -c, --checkpoint FILE    save a snapshot of the run on exit\n"
+            "  -C, --checkpoint-every N also save it every N generations, in the background\n"
+            "  -S, --stats FILE         log the population, births, deaths and bounding box of\n"
+            "                           every generation as CSV, counted while stepping\n"
+            "  -P, --cycles MODE        off, report or stop when the board starts repeating\n"
+            "                           with a period up to %u (default off)\n"
+            "  -d, --density PERCENT    live cells in the random soup (default %u)\n"
+            "  -x, --width N            board width in cells (default %u)\n"
+            "  -y, --height N           board height in cells (default %u)\n"
+            "  -t, --threads N          stepping threads, 0 = one per processor (default 1)\n"
+            "  -b, --boundary MODE      dead, torus or mirror edges (default dead)\n"
+            "  -e, --engine NAME        board, hashlife or chunks, the last two headless only (default board)\n"
+            "  -m, --memory MB          HashLife memory before garbage collection (default %llu)\n"
+            "  -R, --rule B/S           Life-like rule such as B36/S23 (default %s)\n"
+            "  -k, --kernel NAME        stepping kernel for the board (default %s):\n",
+            program, (unsigned long long) DEFAULT_HEADLESS_GENERATIONS, CYCLE_HISTORY - 1, DEFAULT_DENSITY,
+            DEFAULT_BOARD_SIDE, DEFAULT_BOARD_SIDE, (unsigned long long) DEFAULT_MEMORY_LIMIT_MB,
+            DEFAULT_RULE, DEFAULT_KERNEL );
+
+    for ( unsigned i = 0; GetKernel( i ) != NULL; i++ ) {
+        const struct lifeKernel_t * kernel = GetKernel( i );
+
+        printf( "      %-20s %s%s\n", kernel->name, kernel->description,
+                kernel->isSupported() ? "" : " (not supported here)" );
+    }
+
+    printf( "      %-20s the fastest byte kernel this processor supports\n"
+            "  -K, --temporal N         advance bands of rows N generations at a time in the\n"
+            "                           cache, for boards larger than it (default 1 = off)\n"
+            "  -B, --bench              time every supported kernel over a matrix of board\n"
+            "                           sizes, densities and run lengths\n"
+            "  -F, --format FORMAT      benchmark output, csv or json (default csv)\n"
+            "  -T, --trials N           timed runs of every benchmark case (default %u)\n"
+            "  -W, --warmup N           untimed runs before them (default %u)\n"
+            "  -u, --soups N            run N random soups on every processor until they settle\n"
+            "                           and print a census of the objects left; the board size\n"
+            "                           is the box of a soup, -g the generations it may take\n"
+            "                           (default %llu) and -d its density (default %u)\n"
+            "  -U, --soup-side N        cells across a soup (default %u)\n"
+            "  -v, --verbosity LEVEL    error, warning, info or debug messages on stderr\n"
+            "                           (default info)\n"
+            "  -h, --help               show this help\n", "bytes", DEFAULT_TRIALS, DEFAULT_WARMUP_TRIALS,
+            (unsigned long long) DEFAULT_SOUP_GENERATIONS, DEFAULT_SOUP_DENSITY, DEFAULT_SOUP_SIDE );
+}
+
+/* a number of at most maximum for the field it goes to; strtoull would
+   take a minus sign and wrap around */
+static uint64_t ParseNumber( const char * option, const char * text, uint64_t maximum ) {
+    char * end;
+    unsigned long long value;
+
+    errno = 0;
+    value = strtoull( text, &end, 0 );
+    if ( *text == '\0' || *end != '\0' || strchr( text, '-' ) != NULL ) {
+        Abort( "Invalid number for --{}: {}", option, text );
+    }
+
+    if ( errno == ERANGE || value > maximum ) {
+        Abort( "Number out of range for --{}: {}", option, text );
+    }
+
+    return value;
+}
+
+static enum boundary_t ParseBoundary( const char * text ) {
+    if ( strcmp( text, "dead" ) == 0 ) {
+        return BOUNDARY_DEAD;
+    } else if ( strcmp( text, "torus" ) == 0 ) {
+        return BOUNDARY_TORUS;
+    } else if ( strcmp( text, "mirror" ) == 0 ) {
+        return BOUNDARY_MIRROR;
+    }
+
+    Abort( "Unknown boundary: {}", text );
+    return BOUNDARY_DEAD;
+}
+
+static const char * EngineName( enum engine_t engine ) {
+    return ( engine == ENGINE_HASHLIFE ) ? "hashlife" : ( engine == ENGINE_CHUNKS ) ? "chunks" : "board";
+}
+
+static enum engine_t ParseEngine( const char * text ) {
+    if ( strcmp( text, "board" ) == 0 ) {
+        return ENGINE_BOARD;
+    } else if ( strcmp( text, "hashlife" ) == 0 ) {
+        return ENGINE_HASHLIFE;
+    } else if ( strcmp( text, "chunks" ) == 0 ) {
+        return ENGINE_CHUNKS;
+    }
+
+    Abort( "Unknown engine: {}", text );
+    return ENGINE_BOARD;
+}
+
+static enum cycleMode_t ParseCycleMode( const char * text ) {
+    if ( strcmp( text, "off" ) == 0 ) {
+        return CYCLES_OFF;
+    } else if ( strcmp( text, "report" ) == 0 ) {
+        return CYCLES_REPORT;
+    } else if ( strcmp( text, "stop" ) == 0 ) {
+        return CYCLES_STOP;
+    }
+
+    Abort( "Unknown cycle detection mode: {}", text );
+    return CYCLES_OFF;
+}
+
+static const struct lifeKernel_t * ParseKernel( const char * text ) {
+    const struct lifeKernel_t * kernel = FindKernel( text );
+
+    if ( kernel == NULL ) {
+        Abort( "Unknown kernel: {}", text );
+    }
+
+    if ( !kernel->isSupported() ) {
+        Abort( "This processor does not support the kernel: {}", text );
+    }
+
+    return kernel;
+}
+
+static enum benchFormat_t ParseBenchFormat( const char * text ) {
+    if ( strcmp( text, "csv" ) == 0 ) {
+        return BENCH_CSV;
+    } else if ( strcmp( text, "json" ) == 0 ) {
+        return BENCH_JSON;
+    }
+
+    Abort( "Unknown benchmark format: {}", text );
+    return BENCH_CSV;
+}
+
+static struct rule_t ParseRuleOption( const char * text ) {
+    struct rule_t rule;
+
+    if ( !ParseRule( text, &rule ) ) {
+        Abort( "Invalid rule, expected B/S notation such as B3/S23: {}", text );
+    }
+
+    return rule;
+}
+
+void ParseOptions( int argc, char ** argv, struct options_t * options ) {
+    static const struct option longOptions[] = {
+        { "headless",    no_argument,       NULL, 'H' },
+        { "generations", required_argument, NULL, 'g' },
+        { "report",      required_argument, NULL, 'r' },
+        { "seed",        required_argument, NULL, 's' },
+        { "pattern",     required_argument, NULL, 'f' },
+        { "output",      required_argument, NULL, 'o' },
+        { "restore",     required_argument, NULL, 'l' },
+        { "checkpoint",  required_argument, NULL, 'c' },
+        { "checkpoint-every", required_argument, NULL, 'C' },
+        { "stats",       required_argument, NULL, 'S' },
+        { "cycles",      required_argument, NULL, 'P' },
+        { "density",     required_argument, NULL, 'd' },
+        { "width",       required_argument, NULL, 'x' },
+        { "height",      required_argument, NULL, 'y' },
+        { "threads",     required_argument, NULL, 't' },
+        { "boundary",    required_argument, NULL, 'b' },
+        { "engine",      required_argument, NULL, 'e' },
+        { "memory",      required_argument, NULL, 'm' },
+        { "rule",        required_argument, NULL, 'R' },
+        { "kernel",      required_argument, NULL, 'k' },
+        { "temporal",    required_argument, NULL, 'K' },
+        { "bench",       no_argument,       NULL, 'B' },
+        { "format",      required_argument, NULL, 'F' },
+        { "trials",      required_argument, NULL, 'T' },
+        { "warmup",      required_argument, NULL, 'W' },
+        { "soups",       required_argument, NULL, 'u' },
+        { "soup-side",   required_argument, NULL, 'U' },
+        { "verbosity",   required_argument, NULL, 'v' },
+        { "help",        no_argument,       NULL, 'h' },
+        { NULL,          0,                 NULL, 0 }
+    };
+
+    int option;
+    bool generationsGiven = false, densityGiven = false, threadsGiven = false;
+
+    *options = (struct options_t) {
+        .generations = DEFAULT_HEADLESS_GENERATIONS,
+        .width = DEFAULT_BOARD_SIDE,
+        .height = DEFAULT_BOARD_SIDE,
+        .threads = 1,
+        .density = DEFAULT_DENSITY,
+        .memoryLimit = DEFAULT_MEMORY_LIMIT_MB << 20,
+        .rule = ParseRuleOption( DEFAULT_RULE ),
+        .kernel = FindKernel( DEFAULT_KERNEL ),
+        .temporalDepth = 1,
+        .trials = DEFAULT_TRIALS,
+        .warmupTrials = DEFAULT_WARMUP_TRIALS,
+        .soupSide = DEFAULT_SOUP_SIDE,
+        .logLevel = LOG_INFO
+    };
+
+    while ( ( option = getopt_long( argc, argv, "Hg:r:s:f:o:l:c:C:S:P:d:x:y:t:b:e:m:R:k:K:BF:T:W:u:U:v:h", longOptions, NULL ) ) != -1 ) {
+        switch ( option ) {
+        case 'H':
+            options->headless = true;
+            break;
+
+        case 'g':
+            options->generations = ParseNumber( "generations", optarg, UINT64_MAX );
+            generationsGiven = true;
+            break;
+
+        case 'r':
+            options->reportEvery = ParseNumber( "report", optarg, UINT64_MAX );
+            break;
+
+        case 's':
+            options->seeded = true;
+            options->seed = ParseNumber( "seed", optarg, UINT64_MAX );
+            break;
+
+        case 'f':
+            options->patternPath = optarg;
+            break;
+
+        case 'o':
+            options->outputPath = optarg;
+            break;
+
+        case 'l':
+            options->restorePath = optarg;
+            break;
+
+        case 'c':
+            options->checkpointPath = optarg;
+            break;
+
+        case 'C':
+            options->checkpointEvery = ParseNumber( "checkpoint-every", optarg, UINT64_MAX );
+            break;
+
+        case 'S':
+            options->statsPath = optarg;
+            break;
+
+        case 'P':
+            options->cycleMode = ParseCycleMode( optarg );
+            break;
+
+        case 'd':
+            options->density = ParseNumber( "density", optarg, UINT_MAX );
+            densityGiven = true;
+            break;
+
+        case 'x':
+            options->width = ParseNumber( "width", optarg, UINT32_MAX );
+            break;
+
+        case 'y':
+            options->height = ParseNumber( "height", optarg, UINT32_MAX );
+            break;
+
+        case 't':
+            options->threads = ParseNumber( "threads", optarg, UINT_MAX );
+            threadsGiven = true;
+            break;
+
+        case 'b':
+            options->boundary = ParseBoundary( optarg );
+            break;
+
+        case 'e':
+            options->engine = ParseEngine( optarg );
+            break;
+
+        case 'm':
+            options->memoryLimit = ParseNumber( "memory", optarg, UINT64_MAX >> 20 ) << 20;
+            break;
+
+        case 'R':
+            options->rule = ParseRuleOption( optarg );
+            options->ruleGiven = true;
+            break;
+
+        case 'k':
+            options->kernel = ParseKernel( optarg );
+            break;
+
+        case 'K':
+            options->temporalDepth = ParseNumber( "temporal", optarg, UINT_MAX );
+            break;
+
+        case 'B':
+            options->bench = true;
+            break;
+
+        case 'F':
+            options->benchFormat = ParseBenchFormat( optarg );
+            break;
+
+        case 'T':
+            options->trials = ParseNumber( "trials", optarg, UINT_MAX );
+            break;
+
+        case 'W':
+            options->warmupTrials = ParseNumber( "warmup", optarg, UINT_MAX );
+            break;
+
+        case 'u':
+            options->soups = ParseNumber( "soups", optarg, UINT64_MAX );
+            break;
+
+        case 'U':
+            options->soupSide = ParseNumber( "soup-side", optarg, UINT32_MAX );
+            break;
+
+        case 'v':
+            if ( !ParseLogLevel( optarg, &options->logLevel ) ) {
+                Abort( "Unknown verbosity: {}", optarg );
+            }
+            break;
+
+        case 'h':
+            PrintUsage( argv[0] );
+            exit( 0 );
+
+        default:
+            PrintUsage( argv[0] );
+            exit( 1 );
+        }
+    }
+
+    if ( optind < argc ) {
+        Abort( "Unexpected argument: {}", argv[optind] );
+    }
+
+    if ( options->engine != ENGINE_BOARD && !options->headless ) {
+        Abort( "The {} engine only runs with --headless", EngineName( options->engine ) );
+    }
+
+    if ( options->outputPath != NULL && ( !options->headless || options->engine != ENGINE_BOARD ) ) {
+        Abort( "--output only works with --headless and the board engine" );
+    }
+
+    if ( options->checkpointPath != NULL && options->engine != ENGINE_BOARD ) {
+        Abort( "Checkpoints only work with the board engine" );
+    }
+
+    if ( options->checkpointEvery && options->checkpointPath == NULL ) {
+        Abort( "--checkpoint-every needs a --checkpoint file" );
+    }
+
+    if ( options->statsPath != NULL && options->engine != ENGINE_BOARD ) {
+        Abort( "Statistics only work with the board engine" );
+    }
+
+    if ( options->cycleMode != CYCLES_OFF && options->engine != ENGINE_BOARD ) {
+        Abort( "Cycle detection only works with the board engine" );
+    }
+
+    if ( options->restorePath != NULL && options->patternPath != NULL ) {
+        Abort( "Give either a pattern or a snapshot to restore, not both" );
+    }
+
+    /* births from nothing would fill the unbounded plane at once */
+    if ( options->engine != ENGINE_BOARD && options->rule.next[0][0] ) {
+        Abort( "The {} engine cannot run rules with B0: {}", EngineName( options->engine ), options->rule.name );
+    }
+
+    if ( options->width == 0 || options->height == 0 ||
+         options->width > MAX_BOARD_SIDE || options->height > MAX_BOARD_SIDE ) {
+        Abort( "The board sides must be between 1 and 1048576 cells" );
+    }
+
+    if ( options->density > 100 ) {
+        Abort( "The density is a percentage, at most 100" );
+    }
+
+    if ( options->temporalDepth == 0 || options->temporalDepth > MAX_TEMPORAL_DEPTH ) {
+        Abort( "The temporal blocking depth must be between 1 and 64" );
+    }
+
+    if ( options->trials == 0 ) {
+        Abort( "The benchmark needs at least one trial" );
+    }
+
+    if ( options->soups == 0 ) {
+        return;
+    }
+
+    /* a soup search has defaults of its own */
+    options->generations = generationsGiven ? options->generations : DEFAULT_SOUP_GENERATIONS;
+    options->density = densityGiven ? options->density : DEFAULT_SOUP_DENSITY;
+    options->threads = threadsGiven ? options->threads : 0;
+
+    if ( options->engine != ENGINE_BOARD ) {
+        Abort( "The soup search only works with the board engine" );
+    }
+
+    if ( options->patternPath != NULL || options->restorePath != NULL || options->outputPath != NULL ||
+         options->checkpointPath != NULL || options->statsPath != NULL ) {
+        Abort( "The soup search plants its own soups and writes no files" );
+    }
+
+    if ( options->soupSide == 0 || options->soupSide > options->width || options->soupSide > options->height ) {
+        Abort( "The soup side must be between 1 and the board side" );
+    }
+
+    /* a soup would fill its box at once */
+    if ( options->rule.next[0][0] ) {
+        Abort( "The soup search cannot run rules with B0: {}", options->rule.name );
+    }
+}
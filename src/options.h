@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "cycles.h"
+#include "kernel.h"
+#include "log.h"
+#include "rule.h"
+
+/* what advances the universe */
+enum engine_t {
+    ENGINE_BOARD,   /* the bounded board, one generation at a time */
+    ENGINE_HASHLIFE, /* memoized quadtree on an unbounded plane, headless only */
+    ENGINE_CHUNKS    /* 64x64 chunks allocated as the pattern spreads, headless only */
+};
+
+enum benchFormat_t {
+    BENCH_CSV,
+    BENCH_JSON
+};
+
+/* Everything that can be chosen from the command line. */
+struct options_t {
+    bool         headless;    /* run without a window and print statistics */
+    uint64_t     generations; /* generations to run in headless mode */
+    uint64_t     reportEvery; /* print the population every N generations, 0 = never */
+    bool         seeded;      /* seed given explicitly, otherwise the time is used */
+    uint64_t     seed;
+    const char * patternPath; /* start from this pattern instead of a random soup */
+    const char * outputPath;  /* write the final board here as RLE in headless mode */
+    const char * restorePath; /* continue the run saved in this snapshot */
+    const char * checkpointPath; /* snapshot written every checkpointEvery generations and on exit */
+    uint64_t     checkpointEvery;
+    const char * statsPath;   /* collect statistics while stepping and log them here as CSV */
+    enum cycleMode_t cycleMode;
+    unsigned     density;     /* percent of live cells in the random soup */
+    uint32_t     width;       /* board size in cells */
+    uint32_t     height;
+    unsigned     threads;     /* stepping threads, 0 = one per processor */
+    enum boundary_t boundary;
+    enum engine_t engine;
+    bool         ruleGiven;   /* rule given explicitly, otherwise a pattern may choose it */
+    struct rule_t rule;
+    const struct lifeKernel_t * kernel;
+    unsigned     temporalDepth; /* generations per pass over the board, 1 = no temporal blocking */
+    uint64_t     memoryLimit; /* bytes the HashLife engine may use before collecting */
+    bool         bench;       /* time the kernels instead of running a simulation */
+    enum benchFormat_t benchFormat;
+    unsigned     trials;      /* timed runs of every benchmark case */
+    unsigned     warmupTrials; /* untimed runs before them */
+    uint64_t     soups;       /* random soups to run and census instead of a simulation, 0 = none */
+    uint32_t     soupSide;    /* cells across a soup, planted in the middle of the board */
+    enum logLevel_t logLevel; /* the least important messages written to stderr */
+};
+
+void ParseOptions( int, char **, struct options_t * );
+
+#endif
@@ -0,0 +1,369 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "pattern.h"
+#include "util.h"
+
+#define READ_BUFFER_SIZE ( 1 << 16 )
+#define HEADER_SIZE      1024
+#define RLE_LINE_LENGTH  70 /* the longest line written, as other programs expect */
+
+/* The RLE body is parsed straight out of a fixed buffer, a character at a
+   time, so no line or string is ever built however large the file. */
+struct reader_t {
+    FILE * file;
+    size_t length;
+    size_t position;
+    char   buffer[READ_BUFFER_SIZE];
+};
+
+static inline int ReadChar( struct reader_t * reader ) {
+    if ( reader->position == reader->length ) {
+        reader->length = fread( reader->buffer, 1, READ_BUFFER_SIZE, reader->file );
+        reader->position = 0;
+        if ( reader->length == 0 ) {
+            return EOF;
+        }
+    }
+
+    return (unsigned char) reader->buffer[reader->position++];
+}
+
+/* measures the pattern so it can be centred before any cell is placed */
+static void MeasurePattern( FILE * file, uint32_t * width, uint32_t * height ) {
+    char *  line = NULL;
+    size_t  capacity = 0;
+    size_t  lineWidth;
+
+    *width = 0;
+    *height = 0;
+
+    while ( getline( &line, &capacity, file ) != -1 ) {
+        if ( line[0] == '!' ) {
+            continue;
+        }
+
+        lineWidth = strcspn( line, "\r\n" );
+        if ( lineWidth > *width ) {
+            *width = ( lineWidth > MAX_BOARD_SIDE ) ? MAX_BOARD_SIDE + 1 : lineWidth;
+        }
+        (*height)++;
+    }
+
+    free( line );
+}
+
+static void LoadPlaintext( const char * path, FILE * file, struct board_t * board ) {
+    char *   line = NULL;
+    size_t   capacity = 0;
+    uint32_t width, height, top, left, row = 0;
+
+    MeasurePattern( file, &width, &height );
+    if ( width > board->width || height > board->height ) {
+        fclose( file );
+        Abort( "Pattern does not fit on the board: {}", path );
+    }
+
+    top = ( board->height - height ) / 2;
+    left = ( board->width - width ) / 2;
+
+    rewind( file );
+    while ( getline( &line, &capacity, file ) != -1 ) {
+        if ( line[0] == '!' ) {
+            continue;
+        }
+
+        for ( uint32_t col = 0; line[col] != '\0' && line[col] != '\r' && line[col] != '\n'; col++ ) {
+            if ( line[col] == 'O' || line[col] == '*' ) {
+                BoardSetCell( board, top + row, left + col, 1 );
+            }
+        }
+        row++;
+    }
+
+    free( line );
+}
+
+/* reads a line into the header, false at the end of the file */
+static bool ReadLine( struct reader_t * reader, char * line, size_t size ) {
+    size_t length = 0;
+    int    c;
+
+    while ( ( c = ReadChar( reader ) ) != EOF && c != '\n' ) {
+        if ( length + 1 < size ) {
+            line[length++] = c;
+        }
+    }
+    line[length] = '\0';
+
+    return c != EOF || length > 0;
+}
+
+static char * Trim( char * text ) {
+    char * end;
+
+    while ( isspace( (unsigned char) *text ) ) {
+        text++;
+    }
+
+    for ( end = text + strlen( text ); end > text && isspace( (unsigned char) end[-1] ); end-- ) {
+        end[-1] = '\0';
+    }
+
+    return text;
+}
+
+/* The header is a comma separated list of key = value pairs, only x and y
+   being required. A rule may carry a :topology suffix, which is ignored;
+   it ends the header and may hold commas of its own, as in :T20,20. */
+static bool ParseHeader( const char * path, char * line, uint32_t * width, uint32_t * height, struct rule_t * rule ) {
+    bool hasWidth = false, hasHeight = false, hasRule = false;
+
+    line[strcspn( line, ":" )] = '\0';
+    for ( char * pair = strtok( line, "," ); pair != NULL; pair = strtok( NULL, "," ) ) {
+        char * value = strchr( pair, '=' );
+        char * key;
+        char * end;
+
+        if ( value == NULL ) {
+            Abort( "Malformed RLE header in {}", path );
+        }
+        *value = '\0';
+        key = Trim( pair );
+        value = Trim( value + 1 );
+
+        if ( strcmp( key, "x" ) == 0 || strcmp( key, "y" ) == 0 ) {
+            unsigned long long size = strtoull( value, &end, 10 );
+
+            if ( *value == '\0' || *end != '\0' || size > MAX_BOARD_SIDE ) {
+                Abort( "Invalid pattern size in {}", path );
+            }
+
+            if ( key[0] == 'x' ) {
+                *width = size;
+                hasWidth = true;
+            } else {
+                *height = size;
+                hasHeight = true;
+            }
+        } else if ( strcmp( key, "rule" ) == 0 ) {
+            if ( !ParseRule( value, rule ) ) {
+                Abort( "Unsupported rule {} in {}", value, path );
+            }
+            hasRule = true;
+        }
+    }
+
+    if ( !hasWidth || !hasHeight ) {
+        Abort( "The RLE header of {} lacks the pattern size", path );
+    }
+
+    return hasRule;
+}
+
+static bool LoadRle( const char * path, FILE * file, struct board_t * board, struct rule_t * rule ) {
+    struct reader_t * reader = malloc( sizeof ( *reader ) );
+    char     header[HEADER_SIZE];
+    uint32_t width = 0, height = 0, top, left;
+    uint64_t row = 0, col = 0, count = 0;
+    bool     hasRule;
+    int      c;
+
+    if ( reader == NULL ) {
+        Abort( "Cannot allocate the pattern reader" );
+    }
+
+    reader->file = file;
+    reader->length = reader->position = 0;
+
+    /* comment lines come before the header */
+    do {
+        if ( !ReadLine( reader, header, sizeof ( header ) ) ) {
+            Abort( "Missing RLE header in {}", path );
+        }
+    } while ( header[0] == '#' || header[strspn( header, " \t\r" )] == '\0' );
+
+    hasRule = ParseHeader( path, header, &width, &height, rule );
+    if ( width > board->width || height > board->height ) {
+        Abort( "Pattern does not fit on the board: {}", path );
+    }
+
+    top = ( board->height - height ) / 2;
+    left = ( board->width - width ) / 2;
+
+    while ( ( c = ReadChar( reader ) ) != EOF && c != '!' ) {
+        uint64_t run;
+
+        if ( c >= '0' && c <= '9' ) {
+            count = count * 10 + ( c - '0' );
+            if ( count > MAX_BOARD_SIDE ) {
+                Abort( "Run too long in {}", path );
+            }
+            continue;
+        }
+
+        if ( isspace( c ) || ( c >= 'p' && c <= 'y' ) ) {
+            /* p to y only prefix the states of rules with more than two */
+            continue;
+        }
+
+        run = count ? count : 1;
+        count = 0;
+
+        if ( c == 'b' || c == '.' ) {
+            col += run;
+        } else if ( c == 'o' || ( c >= 'A' && c <= 'X' ) ) {
+            if ( row >= height || col + run > width ) {
+                Abort( "Pattern cells lie outside its declared size in {}", path );
+            }
+            BoardSetRun( board, top + row, left + col, run );
+            col += run;
+        } else if ( c == '$' ) {
+            row += run;
+            col = 0;
+        } else {
+            Abort( "Unexpected character in the RLE body of {}", path );
+        }
+    }
+
+    free( reader );
+    return hasRule;
+}
+
+static bool EndsWith( const char * text, const char * suffix ) {
+    size_t length = strlen( text ), suffixLength = strlen( suffix );
+
+    return length >= suffixLength && strcasecmp( text + length - suffixLength, suffix ) == 0;
+}
+
+bool LoadPattern( const char * path, struct board_t * board, struct rule_t * rule ) {
+    bool   hasRule = false;
+    FILE * file = fopen( path, "r" );
+
+    if ( file == NULL ) {
+        Abort( "Cannot open pattern file: {}", path );
+    }
+
+    if ( EndsWith( path, ".rle" ) ) {
+        hasRule = LoadRle( path, file, board, rule );
+    } else {
+        LoadPlaintext( path, file, board );
+    }
+
+    fclose( file );
+    return hasRule;
+}
+
+struct writer_t {
+    FILE * file;
+    int    lineLength;
+};
+
+/* writes a run as count and tag, starting a new line rather than going
+   past the usual line length */
+static void WriteRun( struct writer_t * writer, uint64_t run, char tag ) {
+    char token[32];
+    int  length;
+
+    if ( run == 0 ) {
+        return;
+    }
+
+    length = ( run == 1 ) ? snprintf( token, sizeof ( token ), "%c", tag )
+                          : snprintf( token, sizeof ( token ), "%llu%c", (unsigned long long) run, tag );
+
+    if ( writer->lineLength + length > RLE_LINE_LENGTH ) {
+        fputc( '\n', writer->file );
+        writer->lineLength = 0;
+    }
+
+    fputs( token, writer->file );
+    writer->lineLength += length;
+}
+
+void SavePattern( const char * path, const struct board_t * board, const struct rule_t * rule ) {
+    struct writer_t writer = { .file = fopen( path, "w" ), .lineLength = 0 };
+    uint32_t top = board->height, bottom = 0, left = board->width, right = 0;
+    uint64_t emptyRows = 0;
+
+    if ( writer.file == NULL ) {
+        Abort( "Cannot create pattern file: {}", path );
+    }
+
+    /* crop to the live cells */
+    for ( uint32_t row = 0; row < board->height; row++ ) {
+        for ( uint32_t col = 0; col < board->width; col++ ) {
+            if ( BoardGetCell( board, row, col ) ) {
+                top = ( row < top ) ? row : top;
+                bottom = row;
+                left = ( col < left ) ? col : left;
+                right = ( col > right ) ? col : right;
+            }
+        }
+    }
+
+    if ( top > bottom ) {
+        fprintf( writer.file, "x = 0, y = 0, rule = %s\n!\n", rule->name );
+        fclose( writer.file );
+        return;
+    }
+
+    fprintf( writer.file, "x = %u, y = %u, rule = %s\n", right - left + 1, bottom - top + 1, rule->name );
+
+    for ( uint32_t row = top; row <= bottom; row++ ) {
+        uint64_t run = 0;
+        int      state = 0;
+        bool     empty = true;
+
+        for ( uint32_t col = left; col <= right; col++ ) {
+            int alive = BoardGetCell( board, row, col );
+
+            if ( alive != state ) {
+                if ( alive && empty ) {
+                    /* the rows ended so far */
+                    WriteRun( &writer, emptyRows, '$' );
+                    emptyRows = 0;
+                    empty = false;
+                }
+
+                WriteRun( &writer, run, state ? 'o' : 'b' );
+                state = alive;
+                run = 0;
+            }
+            run++;
+        }
+
+        /* trailing dead cells are left out */
+        if ( state ) {
+            WriteRun( &writer, run, 'o' );
+        }
+        emptyRows++;
+    }
+
+    WriteRun( &writer, 1, '!' );
+    fputc( '\n', writer.file );
+
+    if ( fclose( writer.file ) != 0 ) {
+        Abort( "Cannot write pattern file: {}", path );
+    }
+}
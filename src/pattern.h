@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PATTERN_H
+#define PATTERN_H
+
+#include <stdbool.h>
+
+#include "board.h"
+#include "rule.h"
+
+/* Places a pattern file in the middle of the board, aborting if the file
+   cannot be read, is malformed or does not fit. Files ending in .rle are
+   read as run length encoded patterns, the x = , y = , rule = header
+   giving their size; when it names a rule, the rule is stored and true is
+   returned. Anything else is read as plaintext (.cells): lines starting
+   with '!' are comments, 'O' or '*' is a live cell and anything else a
+   dead one. */
+bool LoadPattern( const char *, struct board_t *, struct rule_t * );
+
+/* Writes the live cells of the board as an RLE pattern cropped to their
+   bounding box. */
+void SavePattern( const char *, const struct board_t *, const struct rule_t * );
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+/* Counter-based random numbers: the n-th number of a seed is the SplitMix64
+   output for it, computed on its own. The random cells of a board are a
+   pure function of the seed and their row and column, so any part of the
+   board can be filled by any thread in any order with the same result. */
+
+#include <stdint.h>
+
+#define RANDOM_PRECISION 16 /* bits of the chance of a cell being alive */
+
+static inline uint64_t RandomAt( uint64_t seed, uint64_t counter ) {
+    uint64_t value = seed + ( counter + 1 ) * UINT64_C( 0x9e3779b97f4a7c15 );
+
+    value = ( value ^ ( value >> 30 ) ) * UINT64_C( 0xbf58476d1ce4e5b9 );
+    value = ( value ^ ( value >> 27 ) ) * UINT64_C( 0x94d049bb133111eb );
+    return value ^ ( value >> 31 );
+}
+
+/* a percentage as a chance out of 2^RANDOM_PRECISION */
+static inline uint32_t RandomThreshold( unsigned percent ) {
+    return (uint32_t) ( ( (uint64_t) percent << RANDOM_PRECISION ) + 50 ) / 100;
+}
+
+/* The cells 64 * group to 64 * group + 63 of a row, bit i for cell i, each
+   alive with a chance of threshold / 2^RANDOM_PRECISION. The bits of the
+   threshold are taken from the lowest set one up, each either keeping the
+   cells of a fresh random word alive or those already drawn, which halves
+   and adds the chances bit by bit: at most RANDOM_PRECISION numbers for
+   64 cells, and a single one at 50%. */
+static inline uint64_t RandomCells( uint64_t seed, uint32_t row, uint32_t group, uint32_t threshold ) {
+    uint64_t counter = ( ( (uint64_t) row << 32 ) | group ) * RANDOM_PRECISION;
+    uint64_t cells = 0;
+
+    if ( threshold >= ( 1u << RANDOM_PRECISION ) ) {
+        return ~UINT64_C( 0 );
+    }
+
+    for ( unsigned bit = ( threshold != 0 ) ? (unsigned) __builtin_ctz( threshold ) : RANDOM_PRECISION;
+          bit < RANDOM_PRECISION; bit++ ) {
+        uint64_t random = RandomAt( seed, counter + bit );
+
+        cells = ( ( threshold >> bit ) & 1 ) ? cells | random : cells & random;
+    }
+
+    return cells;
+}
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <ctype.h>
+#include <string.h>
+
+#include "rule.h"
+
+/* reads the neighbour counts after the letter, if any, in any order but
+   each once */
+static const char * ParseCounts( const char * text, char letter, uint8_t counts[9] ) {
+    if ( letter != '\0' ) {
+        if ( toupper( (unsigned char) *text ) != letter ) {
+            return NULL;
+        }
+        text++;
+    }
+
+    for ( ; *text >= '0' && *text <= '8'; text++ ) {
+        if ( counts[*text - '0'] ) {
+            return NULL;
+        }
+        counts[*text - '0'] = 1;
+    }
+
+    return text;
+}
+
+bool ParseRule( const char * text, struct rule_t * rule ) {
+    char * name = rule->name;
+
+    memset( rule, 0, sizeof ( *rule ) );
+
+    if ( isdigit( (unsigned char) *text ) || *text == '/' ) {
+        /* the older S/B notation without letters, 23/3 being Conway */
+        text = ParseCounts( text, '\0', rule->next[1] );
+        if ( text == NULL || *text++ != '/' ) {
+            return false;
+        }
+        text = ParseCounts( text, '\0', rule->next[0] );
+    } else {
+        text = ParseCounts( text, 'B', rule->next[0] );
+        if ( text == NULL || *text++ != '/' ) {
+            return false;
+        }
+        text = ParseCounts( text, 'S', rule->next[1] );
+    }
+
+    if ( text == NULL || *text != '\0' ) {
+        return false;
+    }
+
+    for ( int alive = 0; alive < 2; alive++ ) {
+        *name++ = alive ? 'S' : 'B';
+        for ( int neighbours = 0; neighbours < 9; neighbours++ ) {
+            if ( rule->next[alive][neighbours] ) {
+                *name++ = '0' + neighbours;
+            }
+        }
+        *name++ = alive ? '\0' : '/';
+    }
+
+    return true;
+}
+
+bool RuleIsConway( const struct rule_t * rule ) {
+    return strcmp( rule->name, "B3/S23" ) == 0;
+}
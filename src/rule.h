@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RULE_H
+#define RULE_H
+
+/* Life-like rules: whether a cell lives in the next generation depends only
+   on whether it lives now and on how many of its eight neighbours do. They
+   are written in B/S notation, B3/S23 being Conway's Game of Life. */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DEFAULT_RULE "B3/S23"
+
+struct rule_t {
+    char    name[24];   /* the rule in canonical B/S notation */
+    uint8_t next[2][9]; /* the next state indexed by [alive][neighbours] */
+};
+
+/* Parses a rule such as B36/S23, in either case, or the older 23/36 form
+   listing the survival counts first, returning false when it is not
+   valid. */
+bool ParseRule( const char *, struct rule_t * );
+
+bool RuleIsConway( const struct rule_t * );
+
+#endif
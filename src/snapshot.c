@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "log.h"
+#include "snapshot.h"
+#include "util.h"
+
+static const char     SNAPSHOT_MAGIC[8] = "GOLSNAP";
+static const uint32_t SNAPSHOT_VERSION = 1;
+
+/* FNV-1a over whole words, cheap enough to run alongside the copy */
+#define CHECKSUM_BASIS UINT64_C( 0xcbf29ce484222325 )
+#define CHECKSUM_PRIME UINT64_C( 0x100000001b3 )
+
+static inline uint64_t Checksum( uint64_t checksum, uint64_t word ) {
+    return ( checksum ^ word ) * CHECKSUM_PRIME;
+}
+
+static uint32_t RowWords( uint32_t width ) {
+    return ( width + 63 ) / 64;
+}
+
+/* packs a row of the board into cells, dropping the ghost cells */
+static void PackRow( const struct board_t * board, uint32_t row, uint64_t * cells ) {
+    uint32_t rowWords = RowWords( board->width );
+    uint64_t lastMask = ( board->width & 63 ) ? ( UINT64_C( 1 ) << ( board->width & 63 ) ) - 1 : ~UINT64_C( 0 );
+
+    if ( board->layout == LAYOUT_BYTES ) {
+        const uint8_t * bytes = BoardRowBytes( board, row ) + 1;
+
+        for ( uint32_t word = 0; word < rowWords; word++ ) {
+            uint32_t count = ( board->width - word * 64 < 64 ) ? board->width - word * 64 : 64;
+            uint64_t packed = 0;
+
+            for ( uint32_t bit = 0; bit < count; bit++ ) {
+                packed |= (uint64_t) bytes[word * 64 + bit] << bit;
+            }
+            cells[word] = packed;
+        }
+        return;
+    }
+
+    /* cell col is bit col + 1 of the row, the spare word makes words[rowWords] readable */
+    const uint64_t * words = BoardRow( board, row );
+
+    for ( uint32_t word = 0; word < rowWords; word++ ) {
+        cells[word] = ( words[word] >> 1 ) | ( words[word + 1] << 63 );
+    }
+    cells[rowWords - 1] &= lastMask;
+}
+
+static void UnpackRow( struct board_t * board, uint32_t row, const uint64_t * cells ) {
+    uint32_t rowWords = RowWords( board->width );
+
+    if ( board->layout == LAYOUT_BYTES ) {
+        uint8_t * bytes = BoardRowBytes( board, row ) + 1;
+
+        for ( uint32_t col = 0; col < board->width; col++ ) {
+            bytes[col] = ( cells[col >> 6] >> ( col & 63 ) ) & 1;
+        }
+        return;
+    }
+
+    uint64_t * words = BoardRow( board, row );
+    uint64_t   carry = 0;
+
+    for ( uint32_t word = 0; word < board->wordsPerRow; word++ ) {
+        uint64_t packed = ( word < rowWords ) ? cells[word] : 0;
+
+        words[word] = ( packed << 1 ) | carry;
+        carry = packed >> 63;
+    }
+}
+
+void SnapshotOpen( const char * path, struct snapshot_t * snapshot ) {
+    const struct snapshotHeader_t * header;
+    struct stat status;
+    void * mapping;
+    int descriptor = open( path, O_RDONLY );
+
+    if ( descriptor < 0 || fstat( descriptor, &status ) != 0 ) {
+        Abort( "Cannot open snapshot: {}", path );
+    }
+
+    if ( (size_t) status.st_size < SNAPSHOT_HEADER_BYTES ) {
+        Abort( "Not a snapshot: {}", path );
+    }
+
+    mapping = mmap( NULL, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0 );
+    close( descriptor );
+    if ( mapping == MAP_FAILED ) {
+        Abort( "Cannot map snapshot: {}", path );
+    }
+
+    header = mapping;
+    if ( memcmp( header->magic, SNAPSHOT_MAGIC, sizeof ( SNAPSHOT_MAGIC ) ) != 0 ) {
+        Abort( "Not a snapshot: {}", path );
+    }
+
+    if ( header->version != SNAPSHOT_VERSION ) {
+        Abort( "Unsupported snapshot version: {}", path );
+    }
+
+    if ( header->width == 0 || header->height == 0 ||
+         header->width > MAX_BOARD_SIDE || header->height > MAX_BOARD_SIDE ||
+         header->rowWords != RowWords( header->width ) ||
+         (size_t) status.st_size != SNAPSHOT_HEADER_BYTES + (size_t) header->height * header->rowWords * sizeof ( uint64_t ) ||
+         memchr( header->rule, '\0', sizeof ( header->rule ) ) == NULL ) {
+        Abort( "Corrupt snapshot header: {}", path );
+    }
+
+    /* read once from start to end, so let the kernel read ahead */
+    madvise( mapping, status.st_size, MADV_SEQUENTIAL );
+
+    snapshot->header = header;
+    snapshot->cells = (const uint64_t *) ( (const char *) mapping + SNAPSHOT_HEADER_BYTES );
+    snapshot->mappedBytes = status.st_size;
+}
+
+void SnapshotRestore( const struct snapshot_t * snapshot, struct board_t * board ) {
+    const struct snapshotHeader_t * header = snapshot->header;
+    const uint64_t * cells = snapshot->cells;
+    uint64_t checksum = CHECKSUM_BASIS;
+
+    if ( board->width != header->width || board->height != header->height ) {
+        Abort( "The snapshot does not match the board size" );
+    }
+
+    for ( uint32_t row = 0; row < header->height; row++, cells += header->rowWords ) {
+        for ( uint32_t word = 0; word < header->rowWords; word++ ) {
+            checksum = Checksum( checksum, cells[word] );
+        }
+        UnpackRow( board, row, cells );
+    }
+
+    if ( checksum != header->checksum ) {
+        Abort( "The snapshot checksum does not match, the file is damaged" );
+    }
+}
+
+void SnapshotClose( struct snapshot_t * snapshot ) {
+    munmap( (void *) snapshot->header, snapshot->mappedBytes );
+    snapshot->header = NULL;
+    snapshot->cells = NULL;
+}
+
+/* Written next to the destination and renamed over it once synced, so a
+   crash never leaves a half written snapshot behind the name. */
+static void * WriteSnapshot( void * argument ) {
+    struct snapshotWriter_t * writer = argument;
+    size_t length = strlen( writer->path );
+    char * temporaryPath = malloc( length + sizeof ( ".tmp" ) );
+    FILE * file;
+
+    writer->succeeded = false;
+    if ( temporaryPath == NULL ) {
+        LOG( LOG_ERROR, "Cannot write snapshot %s", writer->path );
+        return NULL;
+    }
+
+    memcpy( temporaryPath, writer->path, length );
+    memcpy( temporaryPath + length, ".tmp", sizeof ( ".tmp" ) );
+
+    file = fopen( temporaryPath, "wb" );
+    if ( file == NULL || fwrite( writer->buffer, 1, writer->bytes, file ) != writer->bytes ||
+         fflush( file ) != 0 || fsync( fileno( file ) ) != 0 ) {
+        LOG( LOG_ERROR, "Cannot write snapshot %s", temporaryPath );
+        if ( file != NULL ) {
+            fclose( file );
+        }
+        free( temporaryPath );
+        return NULL;
+    }
+
+    fclose( file );
+    if ( rename( temporaryPath, writer->path ) != 0 ) {
+        LOG( LOG_ERROR, "Cannot replace snapshot %s", writer->path );
+    } else {
+        LOG( LOG_DEBUG, "Wrote snapshot %s", writer->path );
+        writer->succeeded = true;
+    }
+
+    free( temporaryPath );
+    return NULL;
+}
+
+void SnapshotWriterStart( struct snapshotWriter_t * writer, const struct board_t * board,
+                          const struct rule_t * rule, uint64_t generation ) {
+    uint32_t rowWords = RowWords( board->width );
+    size_t   bytes = SNAPSHOT_HEADER_BYTES + (size_t) board->height * rowWords * sizeof ( uint64_t );
+    struct snapshotHeader_t * header;
+    uint64_t * cells;
+    uint64_t checksum = CHECKSUM_BASIS;
+
+    SnapshotWriterWait( writer );
+
+    if ( writer->bytes != bytes ) {
+        free( writer->buffer );
+        writer->buffer = malloc( bytes );
+        writer->bytes = bytes;
+        if ( writer->buffer == NULL ) {
+            Abort( "Cannot allocate the snapshot buffer" );
+        }
+    }
+
+    memset( writer->buffer, 0, SNAPSHOT_HEADER_BYTES );
+    header = writer->buffer;
+    cells = (uint64_t *) ( (char *) writer->buffer + SNAPSHOT_HEADER_BYTES );
+
+    for ( uint32_t row = 0; row < board->height; row++, cells += rowWords ) {
+        PackRow( board, row, cells );
+        for ( uint32_t word = 0; word < rowWords; word++ ) {
+            checksum = Checksum( checksum, cells[word] );
+        }
+    }
+
+    memcpy( header->magic, SNAPSHOT_MAGIC, sizeof ( SNAPSHOT_MAGIC ) );
+    header->version = SNAPSHOT_VERSION;
+    header->width = board->width;
+    header->height = board->height;
+    header->rowWords = rowWords;
+    header->generation = generation;
+    header->checksum = checksum;
+    memcpy( header->rule, rule->name, sizeof ( header->rule ) );
+
+    writer->writingGeneration = generation;
+    if ( pthread_create( &writer->thread, NULL, WriteSnapshot, writer ) ) {
+        Abort( "Cannot start the snapshot writer" );
+    }
+
+    writer->writing = true;
+}
+
+void SnapshotWriterWait( struct snapshotWriter_t * writer ) {
+    if ( writer->writing ) {
+        pthread_join( writer->thread, NULL );
+        writer->writing = false;
+        writer->saved = writer->succeeded;
+        writer->savedGeneration = writer->writingGeneration;
+    }
+}
+
+void SnapshotWriterFree( struct snapshotWriter_t * writer ) {
+    SnapshotWriterWait( writer );
+    free( writer->buffer );
+    writer->buffer = NULL;
+    writer->bytes = 0;
+}
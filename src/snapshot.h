@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+/* Binary snapshots of a whole run: a header page with the board size, rule,
+   generation and a checksum, followed by the cells bit-packed with 64 per
+   little-endian word, every row starting on a new word and cell ( row, col )
+   being bit col % 64 of word col / 64 of the row. */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "rule.h"
+
+#define SNAPSHOT_HEADER_BYTES 4096 /* so the cells start on a page of the mapping */
+
+struct snapshotHeader_t {
+    char     magic[8];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t rowWords;    /* words of every row of cells */
+    uint64_t generation;
+    uint64_t checksum;    /* of the cells */
+    char     rule[24];    /* in B/S notation */
+};
+
+/* an opened snapshot, mapped rather than read so restoring touches each page once */
+struct snapshot_t {
+    const struct snapshotHeader_t * header;
+    const uint64_t * cells;
+    size_t mappedBytes;
+};
+
+/* Maps the snapshot and checks its header, aborting when the file cannot be
+   read or is not a snapshot. */
+void SnapshotOpen( const char *, struct snapshot_t * );
+
+/* Copies the cells into a board of the snapshot's size, aborting when the
+   checksum does not match. */
+void SnapshotRestore( const struct snapshot_t *, struct board_t * );
+void SnapshotClose( struct snapshot_t * );
+
+/* Writes snapshots in the background. The board is copied before the writer
+   thread starts, so the simulation can carry on at once; the file appears
+   under its name only when it is complete. */
+struct snapshotWriter_t {
+    const char * path;
+    bool         writing;
+    bool         succeeded;       /* set by the writer thread, read once joined */
+    uint64_t     writingGeneration;
+    bool         saved;           /* savedGeneration is on disk */
+    uint64_t     savedGeneration;
+    pthread_t    thread;
+    void *       buffer;          /* header and cells */
+    size_t       bytes;
+};
+
+/* starts writing the board, first waiting for the previous snapshot */
+void SnapshotWriterStart( struct snapshotWriter_t *, const struct board_t *, const struct rule_t *, uint64_t );
+
+/* returns once the snapshot being written is on disk or failed, saved
+   telling which */
+void SnapshotWriterWait( struct snapshotWriter_t * );
+void SnapshotWriterFree( struct snapshotWriter_t * );
+
+#endif
@@ -0,0 +1,567 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "life.h"
+#include "random.h"
+#include "soup.h"
+#include "threadpool.h"
+#include "util.h"
+
+#define MAX_OBJECT_SIDE 40  /* the largest objects Catagolue names by their cells */
+#define SCRATCH_SIDE    ( MAX_OBJECT_SIDE + 2 )
+#define OBJECT_DISTANCE 2   /* live cells this close belong to the same object */
+#define MAX_CODE        352 /* the prefix and 8 strips of 40 columns */
+#define CENSUS_CAPACITY 256 /* initial entries, doubled when three quarters full */
+
+static const char gDigits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+struct censusEntry_t {
+    char *   code;  /* NULL for a free entry */
+    uint64_t hash;
+    uint64_t count;
+};
+
+/* the objects seen, by apgcode, in an open addressing table */
+struct census_t {
+    struct censusEntry_t * entries;
+    uint32_t               capacity; /* a power of two */
+    uint32_t               count;
+};
+
+/* everything one worker needs, so the soups share nothing */
+struct soupWorker_t {
+    struct gameOfLife_t gameOfLife;  /* single threaded, stops on the first cycle */
+    struct board_t      seen;        /* the cells alive in some generation of the cycle */
+    struct board_t      scratch[2];  /* an object stepped on its own */
+    uint32_t *          cells;       /* of the object being gathered, as row * width + col */
+    struct census_t     census;
+    uint64_t            unstable;    /* soups still changing when the generations ran out */
+    uint64_t            generations;
+    uint64_t            edgeObjects; /* left out of the census, the edge of the box may have shaped them */
+    uint64_t            oversized;
+} __attribute__(( aligned( 64 ) ));
+
+struct soupSearch_t {
+    const struct options_t * options;
+    uint64_t                 seed;
+    struct soupWorker_t *    workers;
+};
+
+/* FNV-1a */
+static uint64_t HashCode( const char * code ) {
+    uint64_t hash = UINT64_C( 0xcbf29ce484222325 );
+
+    while ( *code != '\0' ) {
+        hash = ( hash ^ (uint8_t) *code++ ) * UINT64_C( 0x100000001b3 );
+    }
+
+    return hash;
+}
+
+static void CensusCreate( struct census_t * census, uint32_t capacity ) {
+    census->entries = calloc( capacity, sizeof ( struct censusEntry_t ) );
+    if ( census->entries == NULL ) {
+        Abort( "Cannot allocate the census" );
+    }
+
+    census->capacity = capacity;
+    census->count = 0;
+}
+
+static void CensusFree( struct census_t * census ) {
+    for ( uint32_t slot = 0; slot < census->capacity; slot++ ) {
+        free( census->entries[slot].code );
+    }
+
+    free( census->entries );
+    census->entries = NULL;
+}
+
+/* the entry of the code, or the free one where it belongs */
+static struct censusEntry_t * CensusFind( const struct census_t * census, const char * code, uint64_t hash ) {
+    uint32_t slot = (uint32_t) hash & ( census->capacity - 1 );
+
+    while ( census->entries[slot].code != NULL &&
+            ( census->entries[slot].hash != hash || strcmp( census->entries[slot].code, code ) != 0 ) ) {
+        slot = ( slot + 1 ) & ( census->capacity - 1 );
+    }
+
+    return &census->entries[slot];
+}
+
+static void CensusGrow( struct census_t * census ) {
+    struct census_t grown;
+
+    CensusCreate( &grown, census->capacity * 2 );
+    for ( uint32_t slot = 0; slot < census->capacity; slot++ ) {
+        const struct censusEntry_t * entry = &census->entries[slot];
+
+        if ( entry->code != NULL ) {
+            *CensusFind( &grown, entry->code, entry->hash ) = *entry;
+            grown.count++;
+        }
+    }
+
+    free( census->entries );
+    *census = grown;
+}
+
+/* Only the first object of a kind allocates, and most soups leave none
+   that was not seen before. */
+static void CensusAdd( struct census_t * census, const char * code, uint64_t count ) {
+    uint64_t hash = HashCode( code );
+    struct censusEntry_t * entry = CensusFind( census, code, hash );
+
+    if ( entry->code == NULL ) {
+        if ( ( census->count + 1 ) * 4 > census->capacity * 3 ) {
+            CensusGrow( census );
+            entry = CensusFind( census, code, hash );
+        }
+
+        entry->code = strdup( code );
+        if ( entry->code == NULL ) {
+            Abort( "Cannot allocate the census" );
+        }
+        entry->hash = hash;
+        entry->count = 0;
+        census->count++;
+    }
+
+    entry->count += count;
+}
+
+static int CompareEntries( const void * a, const void * b ) {
+    const struct censusEntry_t * left = *(const struct censusEntry_t * const *) a;
+    const struct censusEntry_t * right = *(const struct censusEntry_t * const *) b;
+
+    if ( left->count != right->count ) {
+        return ( left->count < right->count ) ? 1 : -1;
+    }
+
+    return strcmp( left->code, right->code );
+}
+
+/* a cell of a phase seen turned, flipped or both, orientation bit 0
+   flipping the columns, bit 1 the rows and bit 2 swapping the two */
+static inline unsigned OrientedCell( const uint64_t * rows, uint32_t length, uint32_t breadth, unsigned orientation,
+                                     uint32_t u, uint32_t v ) {
+    u = ( orientation & 1 ) ? length - 1 - u : u;
+    v = ( orientation & 2 ) ? breadth - 1 - v : v;
+
+    return ( orientation & 4 ) ? ( rows[u] >> v ) & 1 : ( rows[v] >> u ) & 1;
+}
+
+/* The extended Wechsler format of one orientation of a phase whose cells
+   start at row and column 0: the rows in strips of five, every column of a
+   strip the digit of its five cells, runs of empty columns shortened to
+   0, w, x or y and a count, and the strips joined by z. */
+static size_t Encode( const uint64_t * rows, uint32_t width, uint32_t height, unsigned orientation, char * code ) {
+    uint32_t length = ( orientation & 4 ) ? height : width, breadth = ( orientation & 4 ) ? width : height;
+    size_t size = 0;
+
+    for ( uint32_t strip = 0; strip < breadth; strip += 5 ) {
+        unsigned zeroes = 0;
+
+        if ( strip > 0 ) {
+            code[size++] = 'z';
+        }
+
+        for ( uint32_t u = 0; u < length; u++ ) {
+            unsigned digit = 0;
+
+            for ( uint32_t w = 0; w < 5 && strip + w < breadth; w++ ) {
+                digit |= OrientedCell( rows, length, breadth, orientation, u, strip + w ) << w;
+            }
+
+            if ( digit == 0 ) {
+                zeroes++;
+                continue;
+            }
+
+            /* a strip is at most 40 columns, so a run fits a single y */
+            if ( zeroes == 1 ) {
+                code[size++] = '0';
+            } else if ( zeroes == 2 ) {
+                code[size++] = 'w';
+            } else if ( zeroes == 3 ) {
+                code[size++] = 'x';
+            } else if ( zeroes >= 4 ) {
+                code[size++] = 'y';
+                code[size++] = gDigits[zeroes - 4];
+            }
+
+            zeroes = 0;
+            code[size++] = gDigits[digit];
+        }
+    }
+
+    code[size] = '\0';
+    return size;
+}
+
+/* Keeps in best the shortest code of any orientation of the phase, the
+   first in ASCII order among those as short, best being empty at first. */
+static void Canonize( const uint64_t * rows, char * best ) {
+    uint64_t phase[SCRATCH_SIDE], columns = 0;
+    uint32_t top = SCRATCH_SIDE, bottom = 0, left, width, height;
+    size_t bestSize = strlen( best );
+    char code[MAX_CODE];
+
+    for ( uint32_t row = 0; row < SCRATCH_SIDE; row++ ) {
+        if ( rows[row] != 0 ) {
+            top = ( top < row ) ? top : row;
+            bottom = row;
+            columns |= rows[row];
+        }
+    }
+
+    if ( columns == 0 ) {
+        return;
+    }
+
+    left = (uint32_t) __builtin_ctzll( columns );
+    width = 64 - (uint32_t) __builtin_clzll( columns ) - left;
+    height = bottom - top + 1;
+    for ( uint32_t row = 0; row < height; row++ ) {
+        phase[row] = rows[top + row] >> left;
+    }
+
+    for ( unsigned orientation = 0; orientation < 8; orientation++ ) {
+        size_t size = Encode( phase, width, height, orientation, code );
+
+        if ( bestSize == 0 || size < bestSize || ( size == bestSize && strcmp( code, best ) < 0 ) ) {
+            memcpy( best, code, size + 1 );
+            bestSize = size;
+        }
+    }
+}
+
+/* the cells of every row of a scratch board, column 0 as bit 0 */
+static void ScratchRows( const struct board_t * scratch, uint64_t * rows ) {
+    for ( uint32_t row = 0; row < SCRATCH_SIDE; row++ ) {
+        rows[row] = ( BoardRow( scratch, row )[0] >> 1 ) & ( ( UINT64_C( 1 ) << SCRATCH_SIDE ) - 1 );
+    }
+}
+
+/* Collects the cells seen within OBJECT_DISTANCE of one another, starting
+   from a cell seen, and takes them off the cells seen. */
+static uint32_t GatherObject( struct soupWorker_t * worker, uint32_t row, uint32_t col ) {
+    struct board_t * seen = &worker->seen;
+    uint32_t count = 0;
+
+    BoardSetCell( seen, row, col, 0 );
+    worker->cells[count++] = row * seen->width + col;
+
+    for ( uint32_t next = 0; next < count; next++ ) {
+        uint32_t cellRow = worker->cells[next] / seen->width, cellCol = worker->cells[next] % seen->width;
+        uint32_t rowBegin = ( cellRow > OBJECT_DISTANCE ) ? cellRow - OBJECT_DISTANCE : 0;
+        uint32_t colBegin = ( cellCol > OBJECT_DISTANCE ) ? cellCol - OBJECT_DISTANCE : 0;
+        uint32_t rowEnd = ( cellRow + OBJECT_DISTANCE < seen->height ) ? cellRow + OBJECT_DISTANCE + 1 : seen->height;
+        uint32_t colEnd = ( cellCol + OBJECT_DISTANCE < seen->width ) ? cellCol + OBJECT_DISTANCE + 1 : seen->width;
+
+        for ( uint32_t y = rowBegin; y < rowEnd; y++ ) {
+            for ( uint32_t x = colBegin; x < colEnd; x++ ) {
+                if ( BoardGetCell( seen, y, x ) ) {
+                    BoardSetCell( seen, y, x, 0 );
+                    worker->cells[count++] = y * seen->width + x;
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+/* Objects are at least OBJECT_DISTANCE + 1 cells apart in every generation
+   of the cycle, so no dead cell ever has neighbours in two of them and each
+   one behaves on its own as it does on the board. It is stepped alone until
+   it comes back, which gives its own period, and named by the apgcode of
+   its phases: xs and the population for a still life, xp and the period
+   for an oscillator, then the shortest code of any phase and orientation. */
+static void ClassifyObject( struct soupWorker_t * worker, const struct rule_t * rule, uint32_t count ) {
+    const struct board_t * board = &worker->gameOfLife.board;
+    uint32_t top = UINT32_MAX, bottom = 0, left = UINT32_MAX, right = 0, population = 0;
+    uint64_t initial[SCRATCH_SIDE], rows[SCRATCH_SIDE], period = 0;
+    unsigned current = 0;
+    char best[MAX_CODE] = "", name[MAX_CODE + 32];
+
+    for ( uint32_t i = 0; i < count; i++ ) {
+        uint32_t row = worker->cells[i] / board->width, col = worker->cells[i] % board->width;
+
+        top = ( row < top ) ? row : top;
+        bottom = ( row > bottom ) ? row : bottom;
+        left = ( col < left ) ? col : left;
+        right = ( col > right ) ? col : right;
+    }
+
+    if ( top == 0 || left == 0 || bottom + 1 == board->height || right + 1 == board->width ) {
+        worker->edgeObjects++;
+        return;
+    }
+
+    if ( bottom - top >= MAX_OBJECT_SIDE || right - left >= MAX_OBJECT_SIDE ) {
+        worker->oversized++;
+        return;
+    }
+
+    BoardClear( &worker->scratch[0] );
+    for ( uint32_t i = 0; i < count; i++ ) {
+        uint32_t row = worker->cells[i] / board->width, col = worker->cells[i] % board->width;
+
+        if ( BoardGetCell( board, row, col ) ) {
+            BoardSetCell( &worker->scratch[0], row - top + 1, col - left + 1, 1 );
+            population++;
+        }
+    }
+    ScratchRows( &worker->scratch[0], initial );
+
+    if ( population == 0 ) {
+        worker->oversized++;
+        return;
+    }
+
+    do {
+        /* only a hash collision closing a false cycle keeps it from coming back */
+        if ( period == worker->gameOfLife.cycles.period ) {
+            worker->oversized++;
+            return;
+        }
+
+        ScratchRows( &worker->scratch[current], rows );
+        Canonize( rows, best );
+
+        BoardFillHalo( &worker->scratch[current], BOUNDARY_DEAD );
+        BoardStep( rule, &worker->scratch[current], &worker->scratch[current ^ 1] );
+        current ^= 1;
+        period++;
+
+        ScratchRows( &worker->scratch[current], rows );
+    } while ( memcmp( rows, initial, sizeof ( rows ) ) != 0 );
+
+    if ( period == 1 ) {
+        snprintf( name, sizeof ( name ), "xs%u_%s", population, best );
+    } else {
+        snprintf( name, sizeof ( name ), "xp%llu_%s", (unsigned long long) period, best );
+    }
+
+    CensusAdd( &worker->census, name, 1 );
+}
+
+/* Steps the board once around its cycle, back to where it was, keeping
+   every cell alive on the way. */
+static void GatherCycle( struct soupWorker_t * worker ) {
+    struct gameOfLife_t * gameOfLife = &worker->gameOfLife;
+    size_t words = BoardBytes( &worker->seen ) / sizeof ( uint64_t );
+
+    memcpy( worker->seen.storage, gameOfLife->board.storage, BoardBytes( &worker->seen ) );
+    for ( uint64_t generation = 1; generation < gameOfLife->cycles.period; generation++ ) {
+        StepSimulation( gameOfLife );
+        for ( size_t word = 0; word < words; word++ ) {
+            worker->seen.storage[word] |= gameOfLife->board.storage[word];
+        }
+    }
+
+    StepSimulation( gameOfLife );
+}
+
+static void TakeCensus( struct soupWorker_t * worker, const struct rule_t * rule ) {
+    struct board_t * seen = &worker->seen;
+    unsigned shift = ( seen->layout == LAYOUT_BYTES ) ? 3 : 0;
+
+    GatherCycle( worker );
+
+    for ( uint32_t row = 0; row < seen->height; row++ ) {
+        for ( uint32_t word = 0; word < seen->wordsPerRow; word++ ) {
+            uint64_t cells = BoardCells( seen, BoardRow( seen, row ), word );
+
+            while ( cells != 0 ) {
+                uint32_t col = ( word << ( 6 - shift ) ) + ( (uint32_t) __builtin_ctzll( cells ) >> shift ) - 1;
+
+                /* the cells gathered with an earlier object are gone */
+                cells &= cells - 1;
+                if ( BoardGetCell( seen, row, col ) ) {
+                    ClassifyObject( worker, rule, GatherObject( worker, row, col ) );
+                }
+            }
+        }
+    }
+}
+
+/* a random square of cells in the middle of an empty board, from a seed of its own */
+static void PlantSoup( struct gameOfLife_t * gameOfLife, const struct options_t * options, uint64_t seed, uint64_t soup ) {
+    struct board_t * board = &gameOfLife->board;
+    uint32_t top = ( board->height - options->soupSide ) / 2, left = ( board->width - options->soupSide ) / 2;
+
+    BoardClear( board );
+    BoardFillRandom( board, RandomAt( seed, soup ), options->density,
+                     top, top + options->soupSide, left, left + options->soupSide );
+
+    gameOfLife->generation = 0;
+    InvalidateSimulation( gameOfLife );
+}
+
+/* the soups are dealt out in turn, they are too many for the luck of the
+   draw to leave a worker with much more to do */
+static void SearchSoups( void * context, unsigned worker, unsigned workers ) {
+    struct soupSearch_t * search = context;
+    struct soupWorker_t * soupWorker = &search->workers[worker];
+    struct gameOfLife_t * gameOfLife = &soupWorker->gameOfLife;
+
+    for ( uint64_t soup = worker; soup < search->options->soups; soup += workers ) {
+        PlantSoup( gameOfLife, search->options, search->seed, soup );
+        AdvanceSimulation( gameOfLife, search->options->generations );
+
+        if ( gameOfLife->halted ) {
+            TakeCensus( soupWorker, &gameOfLife->rule );
+        } else {
+            soupWorker->unstable++;
+        }
+
+        soupWorker->generations += gameOfLife->generation;
+    }
+}
+
+static void CreateWorker( struct soupWorker_t * worker, const struct options_t * options ) {
+    struct options_t soupOptions = *options;
+
+    /* an empty board to start, the soups are planted by the worker */
+    soupOptions.threads = 1;
+    soupOptions.cycleMode = CYCLES_STOP;
+    soupOptions.temporalDepth = 1;
+    soupOptions.seeded = true;
+    soupOptions.density = 0;
+
+    InitializeSimulation( &worker->gameOfLife, &soupOptions );
+    worker->gameOfLife.quiet = true;
+
+    BoardAllocate( &worker->seen, options->width, options->height, worker->gameOfLife.kernel->layout );
+    BoardAllocate( &worker->scratch[0], SCRATCH_SIDE, SCRATCH_SIDE, LAYOUT_BITS );
+    BoardAllocate( &worker->scratch[1], SCRATCH_SIDE, SCRATCH_SIDE, LAYOUT_BITS );
+    worker->cells = malloc( (size_t) options->width * options->height * sizeof ( uint32_t ) );
+    if ( worker->cells == NULL ) {
+        Abort( "Cannot allocate the soup search" );
+    }
+
+    CensusCreate( &worker->census, CENSUS_CAPACITY );
+}
+
+static void FreeWorker( struct soupWorker_t * worker ) {
+    DestroySimulation( &worker->gameOfLife );
+    BoardFree( &worker->seen );
+    BoardFree( &worker->scratch[0] );
+    BoardFree( &worker->scratch[1] );
+    free( worker->cells );
+    CensusFree( &worker->census );
+}
+
+static void PrintCensus( const struct census_t * census ) {
+    const struct censusEntry_t ** entries = malloc( ( census->count + 1 ) * sizeof ( *entries ) );
+    uint32_t count = 0;
+
+    if ( entries == NULL ) {
+        Abort( "Cannot allocate the census" );
+    }
+
+    for ( uint32_t slot = 0; slot < census->capacity; slot++ ) {
+        if ( census->entries[slot].code != NULL ) {
+            entries[count++] = &census->entries[slot];
+        }
+    }
+
+    qsort( entries, count, sizeof ( *entries ), CompareEntries );
+
+    printf( "%12s  %s\n", "count", "object" );
+    for ( uint32_t i = 0; i < count; i++ ) {
+        printf( "%12llu  %s\n", (unsigned long long) entries[i]->count, entries[i]->code );
+    }
+
+    free( entries );
+}
+
+void RunSoupSearch( const struct options_t * options ) {
+    unsigned threads = ( options->threads > 0 ) ? options->threads : ProcessorCount();
+    struct soupSearch_t search = {
+        .options = options,
+        .seed = options->seeded ? options->seed : (uint64_t) time( 0 )
+    };
+    struct threadPool_t * pool;
+    struct census_t census;
+    uint64_t unstable = 0, generations = 0, edgeObjects = 0, oversized = 0, startTime;
+    double seconds;
+
+    threads = ( threads > MAX_THREADS ) ? MAX_THREADS : threads;
+    threads = ( threads > options->soups ) ? (unsigned) options->soups : threads;
+
+    search.workers = aligned_alloc( _Alignof ( struct soupWorker_t ), threads * sizeof ( struct soupWorker_t ) );
+    if ( search.workers == NULL ) {
+        Abort( "Cannot allocate the soup search" );
+    }
+
+    memset( search.workers, 0, threads * sizeof ( struct soupWorker_t ) );
+    for ( unsigned worker = 0; worker < threads; worker++ ) {
+        CreateWorker( &search.workers[worker], options );
+    }
+    pool = ThreadPoolCreate( threads );
+
+    printf( "soup search: %llu soups of %ux%u cells at %u%% in %ux%u boxes, rule %s, seed %llu, %u threads\n",
+            (unsigned long long) options->soups, options->soupSide, options->soupSide, options->density,
+            options->width, options->height, search.workers[0].gameOfLife.rule.name,
+            (unsigned long long) search.seed, threads );
+
+    startTime = NanoTime();
+    ThreadPoolRun( pool, SearchSoups, &search );
+    seconds = ( NanoTime() - startTime ) / 1e9;
+
+    /* the workers are done, their censuses add up to the search's */
+    CensusCreate( &census, CENSUS_CAPACITY );
+    for ( unsigned worker = 0; worker < threads; worker++ ) {
+        struct soupWorker_t * soupWorker = &search.workers[worker];
+
+        for ( uint32_t slot = 0; slot < soupWorker->census.capacity; slot++ ) {
+            if ( soupWorker->census.entries[slot].code != NULL ) {
+                CensusAdd( &census, soupWorker->census.entries[slot].code, soupWorker->census.entries[slot].count );
+            }
+        }
+
+        unstable += soupWorker->unstable;
+        generations += soupWorker->generations;
+        edgeObjects += soupWorker->edgeObjects;
+        oversized += soupWorker->oversized;
+        FreeWorker( soupWorker );
+    }
+
+    ThreadPoolDestroy( pool );
+    free( search.workers );
+
+    PrintCensus( &census );
+    CensusFree( &census );
+
+    printf( "%llu soups settled, %llu still changing after %llu generations\n",
+            (unsigned long long) ( options->soups - unstable ), (unsigned long long) unstable,
+            (unsigned long long) options->generations );
+    if ( edgeObjects > 0 || oversized > 0 ) {
+        printf( "left out: %llu objects touching the edge of the box, %llu larger than %ux%u\n",
+                (unsigned long long) edgeObjects, (unsigned long long) oversized, MAX_OBJECT_SIDE, MAX_OBJECT_SIDE );
+    }
+    printf( "%.3f s, %.1f soups/s, %.4e generations/s\n",
+            seconds, options->soups / seconds, generations / seconds );
+}
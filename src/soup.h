@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SOUP_H
+#define SOUP_H
+
+#include "options.h"
+
+/* Runs options->soups random soups of options->soupSide cells square, each
+   in the middle of its own empty board of the width and height given,
+   until the board repeats or options->generations run out. Every worker
+   thread owns a board it reuses from soup to soup, so a soup allocates
+   nothing. The objects left behind are named by their apgcode, the name
+   Catagolue gives them, and the census of all of them is printed to stdout
+   with the soups per second. */
+void RunSoupSearch( const struct options_t * );
+
+#endif
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+
+#include "log.h"
+#include "stats.h"
+#include "util.h"
+
+static void WriteLine( struct statsCollector_t * collector ) {
+    const struct lifeStats_t * stats = &collector->last;
+
+    if ( collector->log == NULL ) {
+        return;
+    }
+
+    fprintf( collector->log, "%llu,%llu,%llu,%llu",
+             (unsigned long long) stats->generation, (unsigned long long) stats->population,
+             (unsigned long long) stats->births, (unsigned long long) stats->deaths );
+
+    /* an empty board has no bounding box */
+    if ( stats->population > 0 ) {
+        fprintf( collector->log, ",%lld,%lld,%lld,%lld\n",
+                 (long long) stats->box.left, (long long) stats->box.top,
+                 (long long) stats->box.right, (long long) stats->box.bottom );
+    } else {
+        fputs( ",,,,\n", collector->log );
+    }
+}
+
+void StatsCreate( struct statsCollector_t * collector, const struct tileSet_t * tiles, const struct board_t * board,
+                  uint64_t generation, const char * logPath ) {
+    collector->tiles = malloc( (size_t) tiles->columns * tiles->rows * sizeof ( struct tileStats_t ) );
+    if ( collector->tiles == NULL ) {
+        Abort( "Cannot allocate the statistics" );
+    }
+
+    collector->log = NULL;
+    if ( logPath != NULL ) {
+        collector->log = fopen( logPath, "w" );
+        if ( collector->log == NULL ) {
+            Abort( "Cannot create statistics log: {}", logPath );
+        }
+        fputs( "generation,population,births,deaths,left,top,right,bottom\n", collector->log );
+    }
+
+    StatsRecount( collector, tiles, NULL, board, generation );
+}
+
+void StatsFree( struct statsCollector_t * collector ) {
+    if ( collector->log != NULL && fclose( collector->log ) != 0 ) {
+        LOG( LOG_ERROR, "Cannot write the statistics log" );
+    }
+
+    free( collector->tiles );
+    collector->tiles = NULL;
+    collector->log = NULL;
+}
+
+/* The tile totals. The tiles listed, or all of them, were just counted and
+   their populations move by their births and deaths. */
+static void AddUp( struct statsCollector_t * collector, const struct tileSet_t * tiles,
+                   const uint32_t * changed, uint32_t changedCount, uint64_t generation ) {
+    struct lifeStats_t * stats = &collector->last;
+    uint32_t top = UINT32_MAX, bottom = 0, left = UINT32_MAX, right = 0;
+
+    *stats = (struct lifeStats_t) { .generation = generation };
+
+    for ( uint32_t i = 0; i < changedCount; i++ ) {
+        struct tileStats_t * tileStats = &collector->tiles[( changed != NULL ) ? changed[i] : i];
+
+        tileStats->population += tileStats->births - tileStats->deaths;
+        stats->births += tileStats->births;
+        stats->deaths += tileStats->deaths;
+    }
+
+    for ( uint32_t tile = 0; tile < tiles->columns * tiles->rows; tile++ ) {
+        const struct tileStats_t * tileStats = &collector->tiles[tile];
+
+        if ( tileStats->population == 0 ) {
+            continue;
+        }
+
+        stats->population += tileStats->population;
+        top = ( tileStats->top < top ) ? tileStats->top : top;
+        bottom = ( tileStats->bottom > bottom ) ? tileStats->bottom : bottom;
+        left = ( tileStats->left < left ) ? tileStats->left : left;
+        right = ( tileStats->right > right ) ? tileStats->right : right;
+    }
+
+    stats->box = (struct boundingBox_t) { .left = left, .top = top, .right = right, .bottom = bottom };
+    WriteLine( collector );
+}
+
+void StatsRecount( struct statsCollector_t * collector, const struct tileSet_t * tiles, const struct board_t * before,
+                   const struct board_t * after, uint64_t generation ) {
+    uint32_t count = tiles->columns * tiles->rows;
+
+    if ( collector->tiles == NULL ) {
+        return;
+    }
+
+    for ( uint32_t tile = 0; tile < count; tile++ ) {
+        struct tileStats_t * tileStats = &collector->tiles[tile];
+        uint32_t rowBegin, rowEnd, wordBegin, wordEnd;
+
+        StatsClearTile( tileStats );
+        TilesGetBounds( tiles, after, tile, &rowBegin, &rowEnd, &wordBegin, &wordEnd );
+
+        if ( before != NULL ) {
+            for ( uint32_t row = rowBegin; row < rowEnd; row++ ) {
+                StatsAddRow( tileStats, after, row, BoardRow( before, row ), BoardRow( after, row ), wordBegin, wordEnd );
+            }
+            continue;
+        }
+
+        /* a board with no past: every cell counts as born, then the births
+           become the population */
+        for ( uint32_t row = rowBegin; row < rowEnd; row++ ) {
+            for ( uint32_t word = wordBegin; word < wordEnd; word++ ) {
+                StatsAddChange( tileStats, 0, BoardCells( after, BoardRow( after, row ), word ) );
+            }
+            StatsAddBounds( tileStats, after, row, BoardRow( after, row ), wordBegin, wordEnd );
+        }
+
+        tileStats->population = tileStats->births;
+        tileStats->births = 0;
+    }
+
+    AddUp( collector, tiles, NULL, count, generation );
+}
+
+void StatsCollect( struct statsCollector_t * collector, const struct tileSet_t * tiles, uint64_t generation ) {
+    AddUp( collector, tiles, tiles->active, tiles->count, generation );
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+/* Population, births, deaths and bounding box of every generation, counted
+   by the kernel from the words it has just written instead of by another
+   pass over the board. Every tile has its own counters, written only by the
+   worker stepping it; a tile that is not stepped keeps its population and
+   bounding box and had no births or deaths, and the population of one that
+   is moves by its births and deaths. */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "board.h"
+#include "tiles.h"
+
+struct tileStats_t {
+    uint64_t population;
+    uint64_t births;
+    uint64_t deaths;
+    uint32_t top;        /* inclusive, top > bottom without live cells */
+    uint32_t bottom;
+    uint32_t left;
+    uint32_t right;
+};
+
+/* a generation of the whole board */
+struct lifeStats_t {
+    uint64_t generation;
+    uint64_t population;
+    uint64_t births;     /* since the generation counted before */
+    uint64_t deaths;
+    struct boundingBox_t box; /* only meaningful with a population */
+};
+
+struct statsCollector_t {
+    struct tileStats_t * tiles; /* NULL when the statistics are off */
+    struct lifeStats_t   last;
+    FILE *               log;   /* a CSV line per generation, or NULL */
+};
+
+/* Turns the statistics on and counts the board as it is, appending every
+   generation to the log file when one is given. */
+void StatsCreate( struct statsCollector_t *, const struct tileSet_t *, const struct board_t *,
+                  uint64_t, const char * );
+void StatsFree( struct statsCollector_t * );
+
+/* Counts every tile of after again, with the births and deaths since before
+   when it is given, for when the board changed without the kernel. */
+void StatsRecount( struct statsCollector_t *, const struct tileSet_t *, const struct board_t *,
+                   const struct board_t *, uint64_t );
+
+/* Adds up the tiles after a step, the active ones having been counted by
+   the kernel. */
+void StatsCollect( struct statsCollector_t *, const struct tileSet_t *, uint64_t );
+
+/* starts a step of the tile, its population is carried over */
+static inline void StatsClearTile( struct tileStats_t * stats ) {
+    stats->births = 0;
+    stats->deaths = 0;
+    stats->top = stats->left = UINT32_MAX;
+    stats->bottom = stats->right = 0;
+}
+
+/* Counts a word of the next generation against the same word before it,
+   both with their ghost cells and padding masked off. Byte cells hold 0 or
+   1, so the bit operations work on them too. */
+static inline void StatsAddChange( struct tileStats_t * stats, uint64_t before, uint64_t after ) {
+    uint64_t changed = before ^ after;
+
+    stats->births += __builtin_popcountll( changed & after );
+    stats->deaths += __builtin_popcountll( changed & before );
+}
+
+/* Widens the bounding box of the tile to the live cells among the words
+   [ wordBegin, wordEnd ) of a row just written, scanning in from both ends,
+   so a busy row costs a word or two and an empty one a compare per word. */
+static inline void StatsAddBounds( struct tileStats_t * stats, const struct board_t * board, uint32_t row,
+                                   const uint64_t * after, uint32_t wordBegin, uint32_t wordEnd ) {
+    unsigned shift = ( board->layout == LAYOUT_BYTES ) ? 3 : 0;
+    uint32_t first = wordBegin, last = wordEnd - 1, left, right;
+    uint64_t cells;
+
+    while ( first < wordEnd && BoardCells( board, after, first ) == 0 ) {
+        first++;
+    }
+    if ( first == wordEnd ) {
+        return;
+    }
+    while ( BoardCells( board, after, last ) == 0 ) {
+        last--;
+    }
+
+    /* the cells are the positions shifted by the ghost cell */
+    cells = BoardCells( board, after, first );
+    left = ( first << ( 6 - shift ) ) + ( __builtin_ctzll( cells ) >> shift ) - 1;
+    cells = BoardCells( board, after, last );
+    right = ( last << ( 6 - shift ) ) + ( ( 63 - __builtin_clzll( cells ) ) >> shift ) - 1;
+
+    stats->top = ( row < stats->top ) ? row : stats->top;
+    stats->bottom = ( row > stats->bottom ) ? row : stats->bottom;
+    stats->left = ( left < stats->left ) ? left : stats->left;
+    stats->right = ( right > stats->right ) ? right : stats->right;
+}
+
+/* Counts the words [ wordBegin, wordEnd ) of a row just written, for the
+   kernels that do not go a word at a time. The row is still in the cache. */
+static inline void StatsAddRow( struct tileStats_t * stats, const struct board_t * board, uint32_t row,
+                                const uint64_t * before, const uint64_t * after, uint32_t wordBegin, uint32_t wordEnd ) {
+    uint32_t eastGhostWord = ( board->width + 1 ) >> ( ( board->layout == LAYOUT_BYTES ) ? 3 : 6 );
+    uint32_t innerBegin = ( wordBegin > 0 ) ? wordBegin : 1;
+    uint32_t innerEnd = ( wordEnd < eastGhostWord ) ? wordEnd : eastGhostWord;
+    uint64_t births = 0, deaths = 0;
+
+    /* the words between the ghost cells in a loop of their own, without masks */
+    for ( uint32_t word = innerBegin; word < innerEnd; word++ ) {
+        uint64_t changed = before[word] ^ after[word];
+
+        births += __builtin_popcountll( changed & after[word] );
+        deaths += __builtin_popcountll( changed & before[word] );
+    }
+    stats->births += births;
+    stats->deaths += deaths;
+
+    for ( uint32_t word = wordBegin; word < wordEnd; word++ ) {
+        if ( word == 0 || word >= eastGhostWord ) {
+            StatsAddChange( stats, BoardCells( board, before, word ), BoardCells( board, after, word ) );
+        }
+    }
+
+    StatsAddBounds( stats, board, row, after, wordBegin, wordEnd );
+}
+
+#endif
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "temporal.h"
+#include "util.h"
+
+#define MIN_BAND_ROWS 8
+
+void TemporalCreate( struct temporalBlocking_t * blocking, const struct board_t * board, unsigned depth, unsigned workers ) {
+    size_t   rowBytes = (size_t) board->stride * sizeof ( uint64_t );
+    uint64_t scratchRows = TEMPORAL_CACHE_BYTES / ( 2 * rowBytes );
+    uint32_t bandRows = ( scratchRows > 2 * depth + MIN_BAND_ROWS ) ? scratchRows - 2 * depth : MIN_BAND_ROWS;
+
+    blocking->depth = depth;
+    blocking->bandRows = ( bandRows < board->height ) ? bandRows : board->height;
+    blocking->workers = workers;
+    blocking->scratch = calloc( 2 * (size_t) workers, sizeof ( struct board_t ) );
+    if ( blocking->scratch == NULL ) {
+        Abort( "Cannot allocate the temporal blocking boards" );
+    }
+
+    for ( unsigned i = 0; i < 2 * workers; i++ ) {
+        BoardAllocate( &blocking->scratch[i], board->width, blocking->bandRows + 2 * depth, board->layout );
+    }
+}
+
+void TemporalFree( struct temporalBlocking_t * blocking ) {
+    for ( unsigned i = 0; blocking->scratch != NULL && i < 2 * blocking->workers; i++ ) {
+        BoardFree( &blocking->scratch[i] );
+    }
+
+    free( blocking->scratch );
+    blocking->scratch = NULL;
+}
+
+/* The board row that a row outside of it stands for, or -1 when it is dead.
+   A mirror edge reflects the whole plane, so the halo of every generation is
+   the reflection of its cells and the rows further out are reflected too. */
+static int64_t SourceRow( int64_t row, uint32_t height, enum boundary_t boundary ) {
+    if ( row >= 0 && row < height ) {
+        return row;
+    }
+
+    switch ( boundary ) {
+    case BOUNDARY_TORUS:
+        row %= height;
+        return ( row < 0 ) ? row + height : row;
+
+    case BOUNDARY_MIRROR:
+        row %= 2 * (int64_t) height;
+        row = ( row < 0 ) ? row + 2 * (int64_t) height : row;
+        return ( row < height ) ? row : 2 * (int64_t) height - 1 - row;
+
+    default:
+        return -1;
+    }
+}
+
+/* the board seen from one of its rows on, so that its row 0 is row firstRow of the board */
+static struct board_t ShiftRows( const struct board_t * board, int64_t firstRow ) {
+    struct board_t shifted = *board;
+
+    shifted.words = board->words + firstRow * (int64_t) board->stride;
+    return shifted;
+}
+
+/* Row i of the scratch boards is row firstRow + i of the board. Away from
+   the top and bottom edges the first generation is stepped straight from
+   the board and its halo, and the last one straight into dst, so a band is
+   read and written once. */
+static void StepBand( struct board_t * scratch, const struct lifeKernel_t * kernel, const struct rule_t * rule,
+                      enum boundary_t boundary, const struct board_t * src, struct board_t * dst,
+                      uint32_t rowBegin, uint32_t rowEnd, unsigned generations ) {
+    struct board_t * current = &scratch[0], * next = &scratch[1], * swap;
+    struct board_t source, destination;
+    size_t   rowBytes = src->wordsPerRow * sizeof ( uint64_t );
+    uint32_t rows = rowEnd - rowBegin + 2 * generations;
+    int64_t  firstRow = (int64_t) rowBegin - generations;
+    bool     inside = firstRow + 1 >= 0 && (int64_t) rowEnd + generations - 1 <= src->height;
+    unsigned generation = 1;
+
+    if ( inside ) {
+        source = ShiftRows( src, firstRow );
+        kernel->stepTile( rule, &source, current, 1, rows - 1, 0, src->wordsPerRow, NULL );
+        generation++;
+    } else {
+        /* the rows past the edges come from the boundary, each one copied */
+        for ( uint32_t row = 0; row < rows; row++ ) {
+            int64_t sourceRow = SourceRow( firstRow + row, src->height, boundary );
+
+            if ( sourceRow < 0 ) {
+                memset( BoardRow( next, row ), 0, rowBytes );
+            } else {
+                memcpy( BoardRow( next, row ), BoardRow( src, sourceRow ), rowBytes );
+            }
+        }
+
+        swap = current;
+        current = next;
+        next = swap;
+    }
+
+    /* each generation the rows at both ends go stale, since their neighbours were not copied */
+    for ( ; generation < generations; generation++ ) {
+        BoardFillRowHalo( current, generation - 1, rows - generation + 1, boundary );
+        kernel->stepTile( rule, current, next, generation, rows - generation, 0, src->wordsPerRow, NULL );
+
+        /* the dead plane beyond the board stays dead */
+        for ( uint32_t row = generation; !inside && row < rows - generation; row++ ) {
+            if ( SourceRow( firstRow + row, src->height, boundary ) < 0 ) {
+                memset( BoardRow( next, row ), 0, rowBytes );
+            }
+        }
+
+        swap = current;
+        current = next;
+        next = swap;
+    }
+
+    BoardFillRowHalo( current, generations - 1, rows - generations + 1, boundary );
+    destination = ShiftRows( dst, firstRow );
+    kernel->stepTile( rule, current, &destination, generations, rows - generations, 0, src->wordsPerRow, NULL );
+}
+
+void TemporalStepBands( struct temporalBlocking_t * blocking, unsigned worker, unsigned workers,
+                        const struct lifeKernel_t * kernel, const struct rule_t * rule, enum boundary_t boundary,
+                        const struct board_t * src, struct board_t * dst, unsigned generations ) {
+    uint32_t bands = ( src->height + blocking->bandRows - 1 ) / blocking->bandRows;
+    uint32_t begin = (uint32_t) ( (uint64_t) bands * worker / workers );
+    uint32_t end = (uint32_t) ( (uint64_t) bands * ( worker + 1 ) / workers );
+
+    for ( uint32_t band = begin; band < end; band++ ) {
+        uint32_t rowBegin = band * blocking->bandRows;
+        uint32_t rowEnd = ( rowBegin + blocking->bandRows < src->height ) ? rowBegin + blocking->bandRows : src->height;
+
+        StepBand( &blocking->scratch[2 * worker], kernel, rule, boundary, src, dst, rowBegin, rowEnd, generations );
+    }
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEMPORAL_H
+#define TEMPORAL_H
+
+/* Temporal blocking for boards larger than the cache: the board is cut into
+   bands of whole rows, and each band is advanced depth generations in two
+   small scratch boards, with depth extra rows above and below it that shrink
+   by a row each generation, before it is written back. Every cell is read
+   from and written to memory once per depth generations instead of once per
+   generation. */
+
+#include <stdint.h>
+
+#include "board.h"
+#include "kernel.h"
+
+#define MAX_TEMPORAL_DEPTH 64
+#define TEMPORAL_CACHE_BYTES ( 512u << 10 ) /* what the scratch boards of a worker may take */
+
+struct temporalBlocking_t {
+    unsigned depth;          /* generations per pass, at most this */
+    uint32_t bandRows;
+    unsigned workers;
+    struct board_t * scratch; /* two per worker */
+};
+
+/* Sizes the bands so the scratch boards of a worker fit the cache budget. */
+void TemporalCreate( struct temporalBlocking_t *, const struct board_t *, unsigned, unsigned );
+void TemporalFree( struct temporalBlocking_t * );
+
+/* Advances the bands that belong to the worker by the given number of
+   generations, at least 2 and at most the depth, reading src, whose halo
+   must have been filled, and writing dst. */
+void TemporalStepBands( struct temporalBlocking_t *, unsigned, unsigned, const struct lifeKernel_t *,
+                        const struct rule_t *, enum boundary_t, const struct board_t *, struct board_t *, unsigned );
+
+#endif
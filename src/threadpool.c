@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "threadpool.h"
+#include "util.h"
+
+struct threadPool_t {
+    unsigned          workers;
+    pthread_t *       threads;
+    pthread_barrier_t start;  /* released when a task has been published */
+    pthread_barrier_t finish; /* released when every worker is done with it */
+    threadTask_t      task;
+    void *            context;
+    bool              stopping;
+};
+
+struct workerArguments_t {
+    struct threadPool_t * pool;
+    unsigned              worker;
+};
+
+static void * WorkerMain( void * arguments ) {
+    struct workerArguments_t * workerArguments = arguments;
+    struct threadPool_t * pool = workerArguments->pool;
+    unsigned worker = workerArguments->worker;
+
+    free( workerArguments );
+
+    for ( ;; ) {
+        pthread_barrier_wait( &pool->start );
+        if ( pool->stopping ) {
+            return NULL;
+        }
+
+        pool->task( pool->context, worker, pool->workers );
+        pthread_barrier_wait( &pool->finish );
+    }
+}
+
+struct threadPool_t * ThreadPoolCreate( unsigned workers ) {
+    struct threadPool_t * pool = calloc( 1, sizeof ( *pool ) );
+
+    if ( pool == NULL || workers == 0 ) {
+        Abort( "Cannot create the thread pool" );
+    }
+
+    pool->workers = workers;
+    pool->threads = calloc( workers, sizeof ( pthread_t ) );
+    if ( pool->threads == NULL ) {
+        Abort( "Cannot create the thread pool" );
+    }
+
+    pthread_barrier_init( &pool->start, NULL, workers );
+    pthread_barrier_init( &pool->finish, NULL, workers );
+
+    for ( unsigned worker = 1; worker < workers; worker++ ) {
+        struct workerArguments_t * arguments = malloc( sizeof ( *arguments ) );
+
+        if ( arguments == NULL ) {
+            Abort( "Cannot create the thread pool" );
+        }
+
+        arguments->pool = pool;
+        arguments->worker = worker;
+        if ( pthread_create( &pool->threads[worker], NULL, WorkerMain, arguments ) ) {
+            Abort( "Cannot start a worker thread" );
+        }
+    }
+
+    return pool;
+}
+
+void ThreadPoolDestroy( struct threadPool_t * pool ) {
+    if ( pool == NULL ) {
+        return;
+    }
+
+    pool->stopping = true;
+    pthread_barrier_wait( &pool->start );
+
+    for ( unsigned worker = 1; worker < pool->workers; worker++ ) {
+        pthread_join( pool->threads[worker], NULL );
+    }
+
+    pthread_barrier_destroy( &pool->start );
+    pthread_barrier_destroy( &pool->finish );
+    free( pool->threads );
+    free( pool );
+}
+
+unsigned ThreadPoolSize( const struct threadPool_t * pool ) {
+    return pool->workers;
+}
+
+void ThreadPoolRun( struct threadPool_t * pool, threadTask_t task, void * context ) {
+    if ( pool->workers == 1 ) {
+        task( context, 0, 1 );
+        return;
+    }
+
+    pool->task = task;
+    pool->context = context;
+
+    pthread_barrier_wait( &pool->start );
+    task( context, 0, pool->workers );
+    pthread_barrier_wait( &pool->finish );
+}
+
+unsigned ProcessorCount( void ) {
+    long processors = sysconf( _SC_NPROCESSORS_ONLN );
+
+    return ( processors > 0 ) ? (unsigned) processors : 1;
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+/* A fixed set of worker threads created once and reused for every
+   generation. The calling thread takes part as worker 0. */
+
+typedef void ( * threadTask_t )( void * context, unsigned worker, unsigned workers );
+
+struct threadPool_t;
+
+struct threadPool_t * ThreadPoolCreate( unsigned );
+void ThreadPoolDestroy( struct threadPool_t * );
+unsigned ThreadPoolSize( const struct threadPool_t * );
+
+/* Runs task( context, worker, workers ) once on every worker and returns
+   when all of them have finished. */
+void ThreadPoolRun( struct threadPool_t *, threadTask_t, void * );
+
+/* number of online processors, at least 1 */
+unsigned ProcessorCount( void );
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tiles.h"
+#include "util.h"
+
+void TilesCreate( struct tileSet_t * tiles, const struct board_t * board ) {
+    size_t count;
+
+    /* the ghost cells ride along with the tiles holding the edge cells */
+    tiles->columns = board->width / TILE_CELLS + 1;
+    tiles->rows = ( board->height + TILE_ROWS - 1 ) / TILE_ROWS;
+    tiles->tileWords = ( board->layout == LAYOUT_BYTES ) ? TILE_CELLS / 8 : TILE_CELLS / 64;
+
+    count = (size_t) tiles->columns * tiles->rows;
+    tiles->active = malloc( count * sizeof ( uint32_t ) );
+    tiles->nextActive = malloc( count * sizeof ( uint32_t ) );
+    tiles->changed = malloc( count );
+    tiles->dirty = malloc( count );
+    tiles->queued = calloc( count, sizeof ( uint64_t ) );
+    if ( tiles->active == NULL || tiles->nextActive == NULL || tiles->changed == NULL || tiles->dirty == NULL || tiles->queued == NULL ) {
+        Abort( "Cannot allocate the tiles" );
+    }
+
+    tiles->update = 0;
+    TilesActivateAll( tiles );
+}
+
+void TilesFree( struct tileSet_t * tiles ) {
+    free( tiles->active );
+    free( tiles->nextActive );
+    free( tiles->changed );
+    free( tiles->dirty );
+    free( tiles->queued );
+    tiles->active = tiles->nextActive = NULL;
+    tiles->changed = tiles->dirty = NULL;
+    tiles->queued = NULL;
+}
+
+void TilesActivateAll( struct tileSet_t * tiles ) {
+    tiles->count = tiles->columns * tiles->rows;
+    memset( tiles->dirty, 1, tiles->count );
+    for ( uint32_t tile = 0; tile < tiles->count; tile++ ) {
+        tiles->active[tile] = tile;
+    }
+}
+
+void TilesGetBounds( const struct tileSet_t * tiles, const struct board_t * board, uint32_t tile,
+                     uint32_t * rowBegin, uint32_t * rowEnd, uint32_t * wordBegin, uint32_t * wordEnd ) {
+    uint32_t row = tile / tiles->columns;
+    uint32_t column = tile % tiles->columns;
+
+    *rowBegin = row * TILE_ROWS;
+    *rowEnd = ( row + 1 == tiles->rows ) ? board->height : *rowBegin + TILE_ROWS;
+    *wordBegin = column * tiles->tileWords;
+    *wordEnd = ( column + 1 == tiles->columns ) ? board->wordsPerRow : *wordBegin + tiles->tileWords;
+}
+
+static inline void Queue( struct tileSet_t * tiles, uint32_t row, uint32_t column ) {
+    uint32_t tile = row * tiles->columns + column;
+
+    if ( tiles->queued[tile] != tiles->update ) {
+        tiles->queued[tile] = tiles->update;
+        tiles->nextActive[tiles->count++] = tile;
+    }
+}
+
+void TilesUpdate( struct tileSet_t * tiles, enum boundary_t boundary ) {
+    uint32_t   stepped = tiles->count;
+    uint32_t * swap;
+    bool       wrap = ( boundary == BOUNDARY_TORUS );
+
+    tiles->update++;
+    tiles->count = 0;
+
+    for ( uint32_t i = 0; i < stepped; i++ ) {
+        uint32_t row, column;
+
+        if ( !tiles->changed[i] ) {
+            continue;
+        }
+
+        tiles->dirty[tiles->active[i]] = 1;
+        row = tiles->active[i] / tiles->columns;
+        column = tiles->active[i] % tiles->columns;
+
+        for ( int dy = -1; dy <= 1; dy++ ) {
+            int64_t y = (int64_t) row + dy;
+
+            if ( y < 0 || y >= tiles->rows ) {
+                if ( !wrap ) {
+                    continue;
+                }
+                y = ( y < 0 ) ? tiles->rows - 1 : 0;
+            }
+
+            for ( int dx = -1; dx <= 1; dx++ ) {
+                int64_t x = (int64_t) column + dx;
+
+                if ( x < 0 || x >= tiles->columns ) {
+                    if ( !wrap ) {
+                        continue;
+                    }
+                    x = ( x < 0 ) ? tiles->columns - 1 : 0;
+                }
+
+                Queue( tiles, (uint32_t) y, (uint32_t) x );
+            }
+        }
+    }
+
+    swap = tiles->active;
+    tiles->active = tiles->nextActive;
+    tiles->nextActive = swap;
+}
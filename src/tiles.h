@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILES_H
+#define TILES_H
+
+/* The board is cut into tiles of TILE_ROWS rows by TILE_CELLS cells and a
+   generation only steps the tiles that changed in the previous one or touch
+   one that did, the rest being still lifes or empty space. */
+
+#include <stdint.h>
+
+#include "board.h"
+
+#define TILE_ROWS  16
+#define TILE_CELLS 4096
+
+struct tileSet_t {
+    uint32_t   columns;     /* tiles across the board */
+    uint32_t   rows;        /* tiles down the board */
+    uint32_t   tileWords;   /* words of a row in one tile */
+    uint32_t   count;       /* tiles to step in the next generation */
+    uint32_t * active;      /* their indices, row-major */
+    uint32_t * nextActive;
+    uint8_t  * changed;     /* set by the step for each entry of active */
+    uint8_t  * dirty;       /* per tile, changed since the renderer last looked */
+    uint64_t * queued;      /* per tile, the update that last made it active */
+    uint64_t   update;
+};
+
+void TilesCreate( struct tileSet_t *, const struct board_t * );
+void TilesFree( struct tileSet_t * );
+
+/* makes every tile active and dirty, for when the board was changed from outside */
+void TilesActivateAll( struct tileSet_t * );
+
+/* the rows [ rowBegin, rowEnd ) and row words [ wordBegin, wordEnd ) of a tile */
+void TilesGetBounds( const struct tileSet_t *, const struct board_t *, uint32_t,
+                     uint32_t *, uint32_t *, uint32_t *, uint32_t * );
+
+/* Replaces the active tiles by the changed ones and their neighbours, which
+   wrap around the edges of a torus. */
+void TilesUpdate( struct tileSet_t *, enum boundary_t );
+
+#endif
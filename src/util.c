@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "log.h"
+#include "util.h"
+
+void Abort( const char * errorMessage, ... ) {
+    char message[512];
+    size_t size = 0;
+    va_list stackArguments;
+
+    va_start( stackArguments, errorMessage );
+    for ( int c = 0; errorMessage[c] != '\0' && size + 1 < sizeof ( message ); c++ ) {
+        if ( errorMessage[c] == '{' && errorMessage[c+1] == '}' ) {
+            size += snprintf( message + size, sizeof ( message ) - size, "%s", va_arg( stackArguments, const char * ) );
+            size = ( size < sizeof ( message ) ) ? size : sizeof ( message ) - 1;
+            c++;
+        } else {
+            message[size++] = errorMessage[c];
+        }
+    }
+    va_end( stackArguments );
+    message[size] = '\0';
+
+    /* the message and everything logged before it are out before leaving */
+    LOG( LOG_ERROR, "%s", message );
+    LogStop();
+    exit( 1 );
+}
+
+uint64_t NanoTime( void ) {
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
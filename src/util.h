@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2019  Nitu Robert-Georgian
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UTIL_H
+#define UTIL_H
+
+#include <stdint.h>
+
+#define ARRAY_SIZE( name, type ) ( sizeof( name ) / sizeof ( type ) )
+
+/* Logs the message as an error and exits once it is written; every {} is
+   replaced by the next string argument. */
+void Abort( const char *, ... );
+
+/* monotonic clock in nanoseconds */
+uint64_t NanoTime( void );
+
+#endif